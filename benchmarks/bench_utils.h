@@ -0,0 +1,18 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+// Лучшее из runs время выполнения func в секундах: лучший запуск меньше всего искажён шумом системы
+template <typename Func>
+double BestOfSeconds(int runs, Func func) {
+    double best = std::numeric_limits<double>::max();
+    for (int run = 0; run < runs; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
@@ -0,0 +1,116 @@
+#include "bench_utils.h"
+#include "json.h"
+#include "json_view.h"
+
+#include <cstdio>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Разбор и вывод чисел на документе, где основную часть байтов составляют координаты и расстояния.
+// Для сравнения те же числа читаются через std::stod и выводятся через operator<< потока.
+
+namespace {
+
+constexpr int STOP_COUNT = 100000;
+constexpr int DISTANCES_PER_STOP = 5;
+constexpr int RUNS = 5;
+
+std::string MakeCoordinateDocument(std::vector<std::string>& number_tokens) {
+    std::mt19937 random(34);
+    std::uniform_real_distribution<double> latitude(55.5, 55.9);
+    std::uniform_real_distribution<double> longitude(37.3, 37.9);
+    std::ostringstream out;
+    out.precision(17);
+    out << "{\"base_requests\": [";
+    for (int stop = 0; stop < STOP_COUNT; ++stop) {
+        const double lat = latitude(random);
+        const double lng = longitude(random);
+        out << (stop == 0 ? "" : ",") << "{\"type\": \"Stop\", \"name\": \"S" << stop
+            << "\", \"latitude\": " << lat << ", \"longitude\": " << lng << ", \"road_distances\": {";
+        std::ostringstream lat_token;
+        lat_token.precision(17);
+        lat_token << lat;
+        number_tokens.push_back(lat_token.str());
+        for (int i = 0; i < DISTANCES_PER_STOP; ++i) {
+            const int distance = 100 + static_cast<int>(random() % 5000);
+            out << (i == 0 ? "" : ", ") << "\"S" << (stop + 1 + i) % STOP_COUNT << "\": " << distance;
+            number_tokens.push_back(std::to_string(distance));
+        }
+        out << "}}";
+    }
+    out << "]}";
+    return out.str();
+}
+
+}
+
+int main() {
+    std::vector<std::string> number_tokens;
+    const std::string text = MakeCoordinateDocument(number_tokens);
+    const double megabytes = text.size() / 1e6;
+    std::printf("document: %.1f MB, %d stops\n", megabytes, STOP_COUNT);
+
+    std::optional<json::Document> document;
+    const double load_seconds = BestOfSeconds(RUNS, [&] {
+        std::istringstream input(text);
+        document.emplace(json::Load(input));
+    });
+    std::printf("json::Load:       %7.3f s, %6.1f MB/s\n", load_seconds, megabytes / load_seconds);
+
+    size_t view_nodes = 0;
+    const double view_seconds = BestOfSeconds(RUNS, [&] {
+        const json::view::Document view_document = json::view::Load(json::view::Input::FromString(text));
+        view_nodes += view_document.GetRoot().AsDict().at("base_requests").AsArray().size();
+    });
+    std::printf("json::view::Load: %7.3f s, %6.1f MB/s\n", view_seconds, megabytes / view_seconds);
+
+    size_t printed_bytes = 0;
+    const double print_seconds = BestOfSeconds(RUNS, [&] {
+        std::ostringstream output;
+        json::Print(*document, output, json::PrintMode::COMPACT);
+        printed_bytes = output.str().size();
+    });
+    std::printf("json::Print:      %7.3f s, %6.1f MB/s\n", print_seconds, printed_bytes / 1e6 / print_seconds);
+
+    // Те же числа отдельно от остального разбора
+    double stod_sum = 0.0;
+    const double stod_seconds = BestOfSeconds(RUNS, [&] {
+        for (const std::string& token : number_tokens) {
+            stod_sum += std::stod(token);
+        }
+    });
+    std::string numbers_text = "[";
+    for (const std::string& token : number_tokens) {
+        numbers_text += token;
+        numbers_text += ',';
+    }
+    numbers_text.back() = ']';
+    std::istringstream numbers_input(numbers_text);
+    const json::Document numbers_document = json::Load(numbers_input);
+    const double print_numbers_seconds = BestOfSeconds(RUNS, [&] {
+        std::ostringstream output;
+        json::Print(numbers_document, output, json::PrintMode::COMPACT);
+        numbers_text = output.str();
+    });
+    double load_sum = 0.0;
+    const double load_numbers_seconds = BestOfSeconds(RUNS, [&] {
+        std::istringstream input(numbers_text);
+        const json::Document loaded = json::Load(input);
+        for (const json::Node& node : loaded.GetRoot().AsArray()) {
+            load_sum += node.AsDouble();
+        }
+    });
+    const double stream_seconds = BestOfSeconds(RUNS, [&] {
+        std::ostringstream output;
+        for (const json::Node& node : numbers_document.GetRoot().AsArray()) {
+            output << node.AsDouble() << ',';
+        }
+        printed_bytes += output.str().size();
+    });
+    std::printf("%zu numbers: json::Load %.3f s (std::stod on tokens %.3f s), json::Print %.3f s (operator<< %.3f s)\n",
+        number_tokens.size(), load_numbers_seconds, stod_seconds, print_numbers_seconds, stream_seconds);
+    std::printf("checksum: %zu %.3f %.3f\n", view_nodes + printed_bytes, stod_sum, load_sum);
+}
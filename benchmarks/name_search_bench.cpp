@@ -0,0 +1,70 @@
+#include "bench_utils.h"
+#include "name_search_index.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Поиск по началу названия на 150 тысячах названий: точный и неточный с разными порогами.
+// Запросы — начала случайных названий длиной от 3 до 12 символов, в половине из них один символ заменён.
+
+namespace {
+
+constexpr int NAME_COUNT = 150000;
+constexpr int QUERY_COUNT = 2000;
+constexpr size_t LIMIT = 10;
+constexpr int RUNS = 3;
+
+std::string MakeWord(std::mt19937& random) {
+    static const char* const SYLLABLES[] = { "ka", "ro", "mi", "sta", "le", "no", "vo", "pa", "ri", "dan", "go", "te",
+        "bel", "sa", "zu", "tor", "ny", "ek", "lu", "shi", "ma", "ver", "di", "os" };
+    std::string word;
+    const int syllable_count = 2 + static_cast<int>(random() % 3);
+    for (int i = 0; i < syllable_count; ++i) {
+        word += SYLLABLES[random() % std::size(SYLLABLES)];
+    }
+    word[0] = static_cast<char>(word[0] - 'a' + 'A');
+    return word;
+}
+
+}
+
+int main() {
+    std::mt19937 random(46);
+    std::vector<std::string> names;
+    names.reserve(NAME_COUNT);
+    for (int i = 0; i < NAME_COUNT; ++i) {
+        names.push_back(MakeWord(random) + " " + MakeWord(random) + " " + std::to_string(random() % 100));
+    }
+    const transport_catalogue::NameSearchIndex index({ names.begin(), names.end() });
+
+    std::vector<std::string> queries;
+    for (int i = 0; i < QUERY_COUNT; ++i) {
+        const std::string& name = names[random() % names.size()];
+        std::string query = name.substr(0, 3 + random() % 10);
+        if (i % 2 == 1) {
+            query[random() % query.size()] = 'x';
+        }
+        queries.push_back(std::move(query));
+    }
+
+    std::printf("%d names, %d queries, limit %zu\n", NAME_COUNT, QUERY_COUNT, LIMIT);
+    size_t found = 0;
+    const double prefix_seconds = BestOfSeconds(RUNS, [&] {
+        for (const std::string& query : queries) {
+            found += index.FindByPrefix(query, LIMIT).size();
+        }
+    });
+    std::printf("prefix:           %8.2f us/query\n", prefix_seconds * 1e6 / QUERY_COUNT);
+    for (int max_distance = 0; max_distance <= 2; ++max_distance) {
+        const double fuzzy_seconds = BestOfSeconds(RUNS, [&] {
+            for (const std::string& query : queries) {
+                found += index.FindFuzzy(query, max_distance, LIMIT).size();
+            }
+        });
+        std::printf("fuzzy, distance %d: %8.2f us/query\n", max_distance, fuzzy_seconds * 1e6 / QUERY_COUNT);
+    }
+    std::printf("checksum: %zu\n", found);
+}
@@ -0,0 +1,87 @@
+#include "bench_utils.h"
+#include "perfect_hash.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Поиск названий через PerfectHash со сравнением найденного ключа, как в TransportCatalogue::GetStop,
+// и через std::unordered_map<std::string_view, uint32_t>. Половина запросов — названия не из набора.
+
+namespace {
+
+constexpr int KEY_COUNT = 150000;
+constexpr int RUNS = 5;
+
+std::vector<std::string> MakeNames(std::mt19937& random, int count, const char* prefix) {
+    std::vector<std::string> names;
+    names.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        // Названия разной длины: короткие номера и длинные названия улиц
+        std::string name = prefix + std::to_string(i);
+        if (random() % 3 == 0) {
+            name += " street " + std::to_string(random() % 1000);
+        }
+        names.push_back(std::move(name));
+    }
+    return names;
+}
+
+}
+
+int main() {
+    std::mt19937 random(45);
+    const std::vector<std::string> names = MakeNames(random, KEY_COUNT, "Stop ");
+    const std::vector<std::string> missing = MakeNames(random, KEY_COUNT, "Missing ");
+    const std::vector<std::string_view> keys(names.begin(), names.end());
+
+    std::vector<std::string_view> queries(keys.begin(), keys.end());
+    queries.insert(queries.end(), missing.begin(), missing.end());
+    std::shuffle(queries.begin(), queries.end(), random);
+
+    transport_catalogue::PerfectHash hash;
+    std::vector<std::string_view> keys_by_slot;
+    const double build_seconds = BestOfSeconds(RUNS, [&] {
+        const std::vector<uint32_t> slots = hash.Build(keys);
+        keys_by_slot.assign(keys.size(), {});
+        for (size_t i = 0; i < keys.size(); ++i) {
+            keys_by_slot[slots[i]] = keys[i];
+        }
+    });
+    std::unordered_map<std::string_view, uint32_t> map;
+    const double map_build_seconds = BestOfSeconds(RUNS, [&] {
+        map.clear();
+        map.reserve(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            map.emplace(keys[i], static_cast<uint32_t>(i));
+        }
+    });
+
+    size_t hash_found = 0;
+    const double hash_seconds = BestOfSeconds(RUNS, [&] {
+        hash_found = 0;
+        for (std::string_view query : queries) {
+            hash_found += keys_by_slot[hash.GetSlot(query)] == query;
+        }
+    });
+    size_t map_found = 0;
+    const double map_seconds = BestOfSeconds(RUNS, [&] {
+        map_found = 0;
+        for (std::string_view query : queries) {
+            map_found += map.count(query);
+        }
+    });
+
+    std::printf("%d keys, %zu lookups (half missing)\n", KEY_COUNT, queries.size());
+    std::printf("build:  PerfectHash %.3f s, unordered_map %.3f s\n", build_seconds, map_build_seconds);
+    std::printf("lookup: PerfectHash %.1f ns, unordered_map %.1f ns\n",
+        hash_seconds * 1e9 / queries.size(), map_seconds * 1e9 / queries.size());
+    if (hash_found != map_found || hash_found != keys.size()) {
+        std::printf("MISMATCH: %zu vs %zu\n", hash_found, map_found);
+        return 1;
+    }
+}
@@ -0,0 +1,18 @@
+#!/bin/bash
+# Собирает и запускает микробенчмарки: каждый benchmarks/*_bench.cpp — отдельная программа,
+# которая компонуется со всеми файлами справочника, кроме main.cpp. Имена бенчмарков можно передать аргументами.
+set -e
+cd "$(dirname "$0")/.."
+build_dir="${BUILD_DIR:-benchmarks/build}"
+mkdir -p "$build_dir"
+sources=$(ls transport-catalogue/*.cpp | grep -v '/main.cpp$')
+benchmarks=("$@")
+if [ ${#benchmarks[@]} -eq 0 ]; then
+    benchmarks=(benchmarks/*_bench.cpp)
+fi
+for bench in "${benchmarks[@]}"; do
+    name=$(basename "$bench" .cpp)
+    g++ -std=c++17 -O2 -DNDEBUG -Wall -Wextra -pthread -Itransport-catalogue "benchmarks/$name.cpp" $sources -o "$build_dir/$name"
+    echo "== $name"
+    "$build_dir/$name"
+done
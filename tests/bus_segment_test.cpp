@@ -0,0 +1,70 @@
+#include "test_utils.h"
+
+#include <cmath>
+#include <string>
+
+using namespace std::literals;
+
+namespace {
+
+const std::string BASE_REQUESTS = R"(
+    "base_requests": [
+        {"type": "Bus", "name": "14", "stops": ["A", "B", "C"], "is_roundtrip": false},
+        {"type": "Bus", "name": "24", "stops": ["A", "B", "C", "A"], "is_roundtrip": true},
+        {"type": "Stop", "name": "A", "latitude": 43.590317, "longitude": 39.746833, "road_distances": {"B": 1000}},
+        {"type": "Stop", "name": "B", "latitude": 43.598701, "longitude": 39.730623, "road_distances": {"C": 2000}},
+        {"type": "Stop", "name": "C", "latitude": 43.581969, "longitude": 39.719848, "road_distances": {"A": 4000}}
+    ],
+    "stat_requests": [
+        {"id": 1, "type": "BusSegment", "name": "14", "from": "A", "to": "C"},
+        {"id": 2, "type": "BusSegment", "name": "24", "from": "A", "to": "A"},
+        {"id": 3, "type": "BusSegment", "name": "14", "from": "C", "to": "C"},
+        {"id": 4, "type": "BusSegment", "name": "14", "from": "B", "to": "B"}
+    ])";
+
+void TestRideTimeUsesBusVelocity() {
+    const json::Document responses = RunRequests(
+        "{" + BASE_REQUESTS + R"(, "routing_settings": {"bus_wait_time": 6, "bus_velocity": 40}})");
+    const auto& answer = responses.GetRoot().AsArray().at(0).AsDict();
+    CHECK(answer.at("distance").AsInt() == 3000);
+    CHECK(answer.at("span_count").AsInt() == 2);
+    // 3 км со скоростью 40 км/ч — 4,5 минуты
+    CHECK(std::abs(answer.at("time").AsDouble() - 4.5) < 1e-9);
+}
+
+// Совпадающие остановки задают участок до следующего прохода той же остановки
+void TestSameStopSegment() {
+    const json::Document responses = RunRequests(
+        "{" + BASE_REQUESTS + R"(, "routing_settings": {"bus_wait_time": 6, "bus_velocity": 40}})");
+    const auto& answers = responses.GetRoot().AsArray();
+
+    // Кольцевой маршрут: полный круг
+    const auto& loop = answers.at(1).AsDict();
+    CHECK(loop.at("distance").AsInt() == 7000);
+    CHECK(loop.at("span_count").AsInt() == 3);
+
+    // Конечная некольцевого маршрута проходится один раз
+    const auto& terminal = answers.at(2).AsDict();
+    CHECK(terminal.at("request_id").AsInt() == 3);
+    CHECK(terminal.at("error_message").AsString() == "not found"sv);
+
+    // Промежуточная остановка некольцевого маршрута: до конечной и обратно
+    const auto& turn = answers.at(3).AsDict();
+    CHECK(turn.at("distance").AsInt() == 4000);
+    CHECK(turn.at("span_count").AsInt() == 2);
+}
+
+void TestMissingRoutingSettingsIsReported() {
+    const json::Document responses = RunRequests("{" + BASE_REQUESTS + "}");
+    const auto& answer = responses.GetRoot().AsArray().at(0).AsDict();
+    CHECK(answer.at("request_id").AsInt() == 1);
+    CHECK(answer.at("error_message").AsString() == "routing settings not found"sv);
+}
+
+}
+
+int main() {
+    TestRideTimeUsesBusVelocity();
+    TestSameStopSegment();
+    TestMissingRoutingSettingsIsReported();
+}
@@ -0,0 +1,58 @@
+#include "test_utils.h"
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Координаты в представлении для запросов отличаются от исходных не больше чем на округление:
+// в сборке с TRANSPORT_CATALOGUE_FIXED_POINT_COORDINATES — на половину микроградуса, иначе совпадают
+void TestStopCoordinatesRoundingBound() {
+#ifdef TRANSPORT_CATALOGUE_FIXED_POINT_COORDINATES
+    // Половина шага и погрешность деления на 1e6 при обратном переводе
+    const double bound = 0.5e-6 + 1e-12;
+#else
+    const double bound = 0.0;
+#endif
+    std::mt19937_64 random(48);
+    std::uniform_real_distribution<double> latitude(-90.0, 90.0);
+    std::uniform_real_distribution<double> longitude(-180.0, 180.0);
+    TransportCatalogue catalogue;
+    std::vector<geo::Coordinates> coordinates;
+    for (int i = 0; i < 10000; ++i) {
+        coordinates.push_back({ latitude(random), longitude(random) });
+        catalogue.AddStop("S" + std::to_string(i), coordinates.back().lat, coordinates.back().lng);
+    }
+    // Крайние значения диапазона тоже помещаются в int32 микроградусов
+    coordinates.push_back({ -90.0, -180.0 });
+    catalogue.AddStop("min", -90.0, -180.0);
+    coordinates.push_back({ 90.0, 180.0 });
+    catalogue.AddStop("max", 90.0, 180.0);
+    catalogue.Finalize();
+
+    const CatalogueLayout& layout = catalogue.GetLayout();
+    std::vector<uint32_t> stop_ids;
+    for (uint32_t stop_id = 0; stop_id < layout.GetStopCount(); ++stop_id) {
+        const geo::Coordinates stored = layout.GetStopCoordinates(stop_id);
+        CHECK(std::abs(stored.lat - coordinates[stop_id].lat) <= bound);
+        CHECK(std::abs(stored.lng - coordinates[stop_id].lng) <= bound);
+        stop_ids.push_back(stop_id);
+    }
+    const auto [min_corner, max_corner] = layout.GetStopBounds(stop_ids);
+    CHECK(min_corner == (geo::Coordinates{ -90.0, -180.0 }));
+    CHECK(max_corner == (geo::Coordinates{ 90.0, 180.0 }));
+
+    // Новые координаты попадают в представление с той же точностью
+    catalogue.SetStopCoordinates("S0", 55.7558261, 37.6173012);
+    const geo::Coordinates updated = layout.GetStopCoordinates(catalogue.GetStop("S0")->id);
+    CHECK(std::abs(updated.lat - 55.7558261) <= bound);
+    CHECK(std::abs(updated.lng - 37.6173012) <= bound);
+}
+
+}
+
+int main() {
+    TestStopCoordinatesRoundingBound();
+}
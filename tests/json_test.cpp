@@ -0,0 +1,110 @@
+#include "test_utils.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+using namespace std::literals;
+
+namespace {
+
+json::Node LoadText(const std::string& text) {
+    std::istringstream input(text);
+    return json::Load(input).GetRoot();
+}
+
+std::string PrintCompact(json::Node node) {
+    std::ostringstream output;
+    json::Print(json::Document{ std::move(node) }, output, json::PrintMode::COMPACT);
+    return output.str();
+}
+
+bool SameBits(double lhs, double rhs) {
+    return std::memcmp(&lhs, &rhs, sizeof(double)) == 0;
+}
+
+void TestIntegersRoundTrip() {
+    for (int value : { 0, 1, -1, 37, 123456789, std::numeric_limits<int>::max(), std::numeric_limits<int>::min() }) {
+        const json::Node loaded = LoadText(PrintCompact(value));
+        CHECK(loaded.IsInt());
+        CHECK(loaded.AsInt() == value);
+    }
+}
+
+// Целое, не помещающееся в int, читается как double без исключения
+void TestIntOverflowBecomesDouble() {
+    const json::Node above = LoadText("2147483648");
+    CHECK(above.IsPureDouble());
+    CHECK(above.AsDouble() == 2147483648.0);
+    const json::Node below = LoadText("-2147483649");
+    CHECK(below.IsPureDouble());
+    CHECK(below.AsDouble() == -2147483649.0);
+}
+
+// Кратчайшая запись double, которой он однозначно восстанавливается, читается обратно в тот же double
+void TestShortestDoublesParseBack() {
+    std::mt19937_64 random(34);
+    std::uniform_real_distribution<double> latitude(-90.0, 90.0);
+    for (int i = 0; i < 100000; ++i) {
+        double value = 0.0;
+        if (i % 2 == 0) {
+            value = latitude(random);
+        }
+        else {
+            const uint64_t bits = random();
+            std::memcpy(&value, &bits, sizeof(double));
+            if (value != value || value == std::numeric_limits<double>::infinity() || value == -std::numeric_limits<double>::infinity()) {
+                continue;
+            }
+        }
+        char buffer[32];
+        const auto result = std::to_chars(std::begin(buffer), std::end(buffer), value);
+        const json::Node loaded = LoadText(std::string(buffer, result.ptr));
+        CHECK(loaded.IsDouble());
+        CHECK(SameBits(loaded.AsDouble(), value) || (value == 0.0 && loaded.AsDouble() == 0.0));
+    }
+}
+
+// Вывод double совпадает с operator<< потока с настройками по умолчанию (%g, точность 6),
+// а прочитанное обратно значение отличается от исходного не больше чем на половину единицы шестого знака
+void TestDoublesPrintLikeStream() {
+    std::mt19937_64 random(340);
+    std::uniform_real_distribution<double> coordinate(-180.0, 180.0);
+    std::uniform_real_distribution<double> exponent(-30.0, 30.0);
+    for (int i = 0; i < 100000; ++i) {
+        const double value = i % 2 == 0 ? coordinate(random) : coordinate(random) * std::pow(10.0, exponent(random));
+        std::ostringstream expected;
+        expected << value;
+        const std::string printed = PrintCompact(value);
+        CHECK(printed == expected.str());
+        const double loaded = LoadText(printed).AsDouble();
+        CHECK(std::abs(loaded - value) <= std::abs(value) * 5e-6);
+    }
+}
+
+void TestMalformedNumbersAreRejected() {
+    for (const char* text : { "-", "1.", "1e", "1e+", "-x" }) {
+        bool thrown = false;
+        try {
+            LoadText(text);
+        }
+        catch (const json::ParsingError&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+    }
+}
+
+}
+
+int main() {
+    TestIntegersRoundTrip();
+    TestIntOverflowBecomesDouble();
+    TestShortestDoublesParseBack();
+    TestDoublesPrintLikeStream();
+    TestMalformedNumbersAreRejected();
+}
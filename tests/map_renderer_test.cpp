@@ -0,0 +1,47 @@
+#include "test_utils.h"
+
+#include <string>
+
+using namespace std::literals;
+
+namespace {
+
+const std::string INPUT = R"({
+    "base_requests": [
+        {"type": "Bus", "name": "14", "stops": ["A", "B", "C", "A"], "is_roundtrip": true},
+        {"type": "Bus", "name": "114", "stops": ["B", "D"], "is_roundtrip": false},
+        {"type": "Stop", "name": "A", "latitude": 43.590317, "longitude": 39.746833, "road_distances": {"B": 850}},
+        {"type": "Stop", "name": "B", "latitude": 43.598701, "longitude": 39.730623, "road_distances": {"C": 1740, "D": 900}},
+        {"type": "Stop", "name": "C", "latitude": 43.581969, "longitude": 39.719848, "road_distances": {"A": 1300}},
+        {"type": "Stop", "name": "D", "latitude": 43.578079, "longitude": 39.780482, "road_distances": {}}
+    ],
+    "render_settings": {
+        "width": 600, "height": 400, "padding": 50, "stop_radius": 5, "line_width": 14,
+        "bus_label_font_size": 20, "bus_label_offset": [7, 15],
+        "stop_label_font_size": 20, "stop_label_offset": [7, -3],
+        "underlayer_color": [255, 255, 255, 0.85], "underlayer_width": 3,
+        "color_palette": ["green", [255, 160, 0], "red"]
+    },
+    "routing_settings": {"bus_wait_time": 2, "bus_velocity": 30},
+    "stat_requests": [
+        {"id": 1, "type": "Map"},
+        {"id": 2, "type": "Map"}
+    ]
+})";
+
+void TestRepeatedMapRequestsRenderSameMap() {
+    const json::Document responses = RunRequests(INPUT);
+    const auto& answers = responses.GetRoot().AsArray();
+    CHECK(answers.size() == 2);
+    const std::string first = std::string(answers[0].AsDict().at("map").AsString());
+    const std::string second = std::string(answers[1].AsDict().at("map").AsString());
+    CHECK(!first.empty());
+    CHECK(first.find("<polyline"sv) != std::string::npos);
+    CHECK(first == second);
+}
+
+}
+
+int main() {
+    TestRepeatedMapRequestsRenderSameMap();
+}
@@ -0,0 +1,92 @@
+#include "test_utils.h"
+#include "name_search_index.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Наименьшее расстояние Левенштейна от query до начал name, посимвольно по байтам: в тесте только ASCII
+int PrefixDistance(const std::string& query, const std::string& name) {
+    std::vector<int> row(query.size() + 1);
+    for (size_t j = 0; j < row.size(); ++j) {
+        row[j] = static_cast<int>(j);
+    }
+    int best = row.back();
+    for (size_t i = 0; i < name.size(); ++i) {
+        std::vector<int> next(row.size());
+        next[0] = static_cast<int>(i + 1);
+        for (size_t j = 1; j < row.size(); ++j) {
+            next[j] = std::min({ row[j] + 1, next[j - 1] + 1, row[j - 1] + (name[i] == query[j - 1] ? 0 : 1) });
+        }
+        row = std::move(next);
+        best = std::min(best, row.back());
+    }
+    return best;
+}
+
+std::vector<std::string> FindFuzzySlowly(const std::vector<std::string>& names, const std::string& query, int max_distance, size_t limit) {
+    std::vector<std::pair<int, std::string>> matches;
+    for (const std::string& name : names) {
+        const int distance = PrefixDistance(query, name);
+        if (distance <= max_distance) {
+            matches.emplace_back(distance, name);
+        }
+    }
+    std::sort(matches.begin(), matches.end());
+    std::vector<std::string> result;
+    for (size_t i = 0; i < matches.size() && i < limit; ++i) {
+        result.push_back(matches[i].second);
+    }
+    return result;
+}
+
+// Неточный поиск совпадает с перебором всех названий при любых порогах и ограничениях,
+// в том числе когда ближних совпадений хватает на весь ответ и поиск с большим порогом не нужен
+void TestFuzzyMatchesBruteForce() {
+    std::mt19937 random(46);
+    const std::string alphabet = "abcd ";
+    std::vector<std::string> names;
+    for (int i = 0; i < 400; ++i) {
+        std::string name;
+        const size_t length = 1 + random() % 8;
+        for (size_t j = 0; j < length; ++j) {
+            name += alphabet[random() % alphabet.size()];
+        }
+        names.push_back(std::move(name));
+    }
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    const transport_catalogue::NameSearchIndex index({ names.begin(), names.end() });
+
+    for (int i = 0; i < 2000; ++i) {
+        std::string query;
+        const size_t length = random() % 6;
+        for (size_t j = 0; j < length; ++j) {
+            query += alphabet[random() % alphabet.size()];
+        }
+        const int max_distance = static_cast<int>(random() % 4);
+        const size_t limit = 1 + random() % 20;
+        const std::vector<std::string_view> actual = index.FindFuzzy(query, max_distance, limit);
+        const std::vector<std::string> expected = FindFuzzySlowly(names, query, max_distance, limit);
+        CHECK(std::equal(actual.begin(), actual.end(), expected.begin(), expected.end()));
+    }
+}
+
+void TestPrefixSearch() {
+    const transport_catalogue::NameSearchIndex index({ "Apple", "Apricot", "Banana", "Ap" });
+    const auto found = index.FindByPrefix("Ap", 10);
+    CHECK((found == std::vector<std::string_view>{ "Ap", "Apple", "Apricot" }));
+    CHECK(index.FindByPrefix("Ap", 1).size() == 1);
+    CHECK(index.FindByPrefix("C", 10).empty());
+}
+
+}
+
+int main() {
+    TestFuzzyMatchesBruteForce();
+    TestPrefixSearch();
+}
@@ -0,0 +1,32 @@
+#!/bin/bash
+# Собирает и запускает все тесты в каждой конфигурации сборки: файлы справочника, кроме main.cpp,
+# компилируются один раз на конфигурацию, а каждый tests/*_test.cpp — отдельная программа,
+# которая компонуется с ними
+set -e
+cd "$(dirname "$0")/.."
+build_dir="${BUILD_DIR:-tests/build}"
+flags="-std=c++17 -O2 -Wall -Wextra -pthread -Itransport-catalogue"
+# Имя конфигурации и её дополнительные флаги
+configurations=(
+    "default:"
+    "fixed_point:-DTRANSPORT_CATALOGUE_FIXED_POINT_COORDINATES"
+)
+for configuration in "${configurations[@]}"; do
+    name="${configuration%%:*}"
+    defines="${configuration#*:}"
+    object_dir="$build_dir/$name"
+    mkdir -p "$object_dir"
+    objects=()
+    for source in transport-catalogue/*.cpp; do
+        [ "$(basename "$source")" = main.cpp ] && continue
+        object="$object_dir/$(basename "$source" .cpp).o"
+        g++ $flags $defines -c "$source" -o "$object"
+        objects+=("$object")
+    done
+    for test in tests/*_test.cpp; do
+        test_name=$(basename "$test" .cpp)
+        g++ $flags $defines "$test" "${objects[@]}" -o "$object_dir/$test_name"
+        "$object_dir/$test_name"
+        echo "[$name] $test_name: OK"
+    done
+done
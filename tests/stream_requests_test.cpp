@@ -0,0 +1,109 @@
+#include "test_utils.h"
+
+#include <string>
+#include <vector>
+
+using namespace std::literals;
+
+namespace {
+
+// Документ с базой нарочно занимает несколько строк
+const std::string BASE_DOCUMENT = R"({
+    "base_requests": [
+        {"type": "Bus", "name": "14", "stops": ["A", "B"], "is_roundtrip": false},
+        {"type": "Stop", "name": "A", "latitude": 43.590317, "longitude": 39.746833, "road_distances": {"B": 1000}},
+        {"type": "Stop", "name": "B", "latitude": 43.598701, "longitude": 39.730623, "road_distances": {}}
+    ],
+    "routing_settings": {"bus_wait_time": 6, "bus_velocity": 40}
+}
+)";
+
+// Обрабатывает поток так же, как main с флагом --stream, и разбирает каждую строку вывода
+std::vector<json::Document> RunStreamRequests(json_reader::JSON_Reader& reader, const std::string& input) {
+    TransportCatalogue catalogue;
+    RequestHandler handler(catalogue);
+    std::istringstream in(input);
+    std::ostringstream out;
+    std::streambuf* cout_buffer = std::cout.rdbuf(out.rdbuf());
+    try {
+        reader.ReadStreamRequests(in, catalogue, handler);
+    }
+    catch (...) {
+        std::cout.rdbuf(cout_buffer);
+        throw;
+    }
+    std::cout.rdbuf(cout_buffer);
+
+    std::vector<json::Document> responses;
+    std::istringstream lines(out.str());
+    for (std::string line; std::getline(lines, line);) {
+        std::istringstream line_input(line);
+        responses.push_back(json::Load(line_input));
+    }
+    return responses;
+}
+
+const json::Dict& Response(const std::vector<json::Document>& responses, size_t index) {
+    return responses.at(index).GetRoot().AsDict();
+}
+
+// Каждой непустой строке запроса соответствует ровно одна строка ответа, ошибки не прерывают поток
+void TestMalformedLinesAreAnsweredWithErrors() {
+    json_reader::JSON_Reader reader;
+    const auto responses = RunStreamRequests(reader, BASE_DOCUMENT + R"({"id": 1, "type": "Bus", "name": "14"}
+[1, 2]
+{"id": 3, "type": "Unknown"}
+not json
+{"id": 5, "type": "Stop"}
+
+{"id": 6, "type": "Bus", "name": "14"
+{"id": 7, "type": "Route", "from": "A", "to": "B"}
+)");
+    CHECK(responses.size() == 7);
+
+    CHECK(Response(responses, 0).at("request_id").AsInt() == 1);
+    CHECK(Response(responses, 0).at("route_length").AsInt() == 2000);
+
+    CHECK(Response(responses, 1).at("request_id").IsNull());
+    CHECK(Response(responses, 1).at("error_message").AsString() == "Not a dict"sv);
+
+    CHECK(Response(responses, 2).at("request_id").AsInt() == 3);
+    CHECK(Response(responses, 2).at("error_message").AsString() == "unknown request type"sv);
+
+    CHECK(Response(responses, 3).at("request_id").IsNull());
+    CHECK(Response(responses, 3).count("error_message") == 1);
+
+    CHECK(Response(responses, 4).at("request_id").AsInt() == 5);
+    CHECK(Response(responses, 4).at("error_message").AsString() == "Key 'name' not found"sv);
+
+    // Незакрытый объект не разобран, поэтому номер запроса неизвестен
+    CHECK(Response(responses, 5).at("request_id").IsNull());
+    CHECK(Response(responses, 5).count("error_message") == 1);
+
+    CHECK(Response(responses, 6).at("request_id").AsInt() == 7);
+    CHECK(Response(responses, 6).at("total_time").AsDouble() > 0.0);
+}
+
+// Ошибка в документе с базой прерывает поток, но не портит читателя для следующего документа
+void TestReaderIsReusableAfterBaseError() {
+    json_reader::JSON_Reader reader;
+    bool thrown = false;
+    try {
+        RunStreamRequests(reader, R"({"base_requests": [{"type": "Stop"}]})"s + "\n"s);
+    }
+    catch (const std::exception&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    const auto responses = RunStreamRequests(reader, BASE_DOCUMENT + R"({"id": 1, "type": "Stop", "name": "A"})" + "\n"s);
+    CHECK(responses.size() == 1);
+    CHECK(Response(responses, 0).at("buses").AsArray().size() == 1);
+}
+
+}
+
+int main() {
+    TestMalformedLinesAreAnsweredWithErrors();
+    TestReaderIsReusableAfterBaseError();
+}
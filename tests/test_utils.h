@@ -0,0 +1,30 @@
+#pragma once
+#include "json_reader.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Проверка, которая работает и в сборке с NDEBUG: при нарушении печатает место и завершает тест с ошибкой
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition "\n"; \
+            std::exit(1);                                                                 \
+        }                                                                                 \
+    } while (false)
+
+// Обрабатывает входной документ так же, как main, и возвращает разобранный массив ответов
+inline json::Document RunRequests(const std::string& input) {
+    TransportCatalogue catalogue;
+    RequestHandler handler(catalogue);
+    json_reader::JSON_Reader reader;
+    std::istringstream in(input);
+    std::ostringstream out;
+    std::streambuf* cout_buffer = std::cout.rdbuf(out.rdbuf());
+    reader.ReadRequests(in, catalogue, handler);
+    std::cout.rdbuf(cout_buffer);
+    std::istringstream responses(out.str());
+    return json::Load(responses);
+}
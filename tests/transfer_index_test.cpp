@@ -0,0 +1,81 @@
+#include "test_utils.h"
+#include "transfer_index.h"
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int STOP_COUNT = 200;
+constexpr int BUS_COUNT = 120;
+
+std::string StopName(int index) {
+    return "S" + std::to_string(index);
+}
+
+std::string BusName(int index) {
+    return "B" + std::to_string(index);
+}
+
+bool SameNames(const std::vector<std::string_view>& actual, const std::set<std::string>& lhs, const std::set<std::string>& rhs) {
+    std::vector<std::string> expected;
+    std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(expected));
+    return std::equal(actual.begin(), actual.end(), expected.begin(), expected.end());
+}
+
+// Маршруты и остановки разной плотности, чтобы встретились пересечения плотных строк с плотными,
+// плотных с разреженными и разреженных между собой. Ответы сравниваются с пересечением std::set
+void TestIntersectionsMatchSets() {
+    std::mt19937 random(43);
+    TransportCatalogue catalogue;
+    for (int i = 0; i < STOP_COUNT; ++i) {
+        catalogue.AddStop(StopName(i), 55.6 + (random() % 1000) * 1e-4, 37.5 + (random() % 1000) * 1e-4);
+    }
+    // Первые 10 остановок — узлы, через которые проходит почти каждый маршрут
+    std::vector<std::set<std::string>> stop_buses(STOP_COUNT);
+    std::vector<std::set<std::string>> bus_stops(BUS_COUNT);
+    for (int bus = 0; bus < BUS_COUNT; ++bus) {
+        const int stop_count = bus % 10 == 0 ? 60 + static_cast<int>(random() % 100) : 2 + static_cast<int>(random() % 4);
+        std::vector<Stop*> stops;
+        for (int i = 0; i < stop_count; ++i) {
+            const int stop = random() % 3 == 0 ? static_cast<int>(random() % 10) : static_cast<int>(random() % STOP_COUNT);
+            if (!stops.empty() && stops.back()->name == StopName(stop)) {
+                continue;
+            }
+            stops.push_back(catalogue.GetStop(StopName(stop)));
+            stop_buses[stop].insert(BusName(bus));
+            bus_stops[bus].insert(StopName(stop));
+        }
+        stops.push_back(stops.front());
+        catalogue.AddBus(BusName(bus), stops, true);
+    }
+    catalogue.Finalize();
+    const transport_catalogue::TransferIndex index(catalogue);
+
+    for (int first = 0; first < STOP_COUNT; ++first) {
+        for (int second = 0; second < STOP_COUNT; ++second) {
+            const auto common = index.GetCommonBuses(StopName(first), StopName(second));
+            CHECK(common);
+            CHECK(SameNames(*common, stop_buses[first], stop_buses[second]));
+        }
+    }
+    for (int first = 0; first < BUS_COUNT; ++first) {
+        for (int second = 0; second < BUS_COUNT; ++second) {
+            const auto transfers = index.GetTransferStops(BusName(first), BusName(second));
+            CHECK(transfers);
+            CHECK(SameNames(*transfers, bus_stops[first], bus_stops[second]));
+        }
+    }
+    CHECK(!index.GetCommonBuses("unknown", StopName(0)));
+    CHECK(!index.GetTransferStops(BusName(0), "unknown"));
+}
+
+}
+
+int main() {
+    TestIntersectionsMatchSets();
+}
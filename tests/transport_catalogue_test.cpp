@@ -0,0 +1,120 @@
+#include "test_utils.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// Длиннее буфера короткой строки std::string во всех распространённых реализациях
+const std::string LONG_NAME = "Stop with a name longer than any small string buffer";
+
+void TestNamePoolCountsInternedBytes() {
+    TransportCatalogue catalogue;
+    Stop* a = catalogue.AddStop("A", 55.611087, 37.20829);
+    Stop* long_stop = catalogue.AddStop(LONG_NAME, 55.595884, 37.209755);
+    // Название маршрута совпадает с названием остановки и хранится в пуле один раз
+    catalogue.AddBus("A", { a, long_stop, a }, false);
+
+    const StringPoolStats stats = catalogue.GetNamePoolStats();
+    CHECK(stats.intern_calls == 3);
+    CHECK(stats.unique_strings == 2);
+    CHECK(stats.bytes_used == 1 + LONG_NAME.size());
+    CHECK(stats.bytes_reserved >= stats.bytes_used);
+    CHECK(stats.std_string_bytes == 3 * sizeof(std::string) + LONG_NAME.size() + 1);
+
+    // Та же сводка выводится по флагу --stats
+    std::ostringstream output;
+    json_reader::JSON_Reader().PrintStats(catalogue, output);
+    std::istringstream input(output.str());
+    const json::Document report = json::Load(input);
+    const auto& pool = report.GetRoot().AsDict().at("name_pool").AsDict();
+    CHECK(pool.at("unique_strings").AsInt() == 2);
+    CHECK(pool.at("bytes_used").AsInt() == static_cast<int>(1 + LONG_NAME.size()));
+}
+
+void TestRemovedNamesLeaveThePool() {
+    TransportCatalogue catalogue;
+    Stop* a = catalogue.AddStop("A", 55.611087, 37.20829);
+    Stop* b = catalogue.AddStop("B", 55.595884, 37.209755);
+    catalogue.AddBus(LONG_NAME, { a, b, a }, false);
+
+    CHECK(!catalogue.RemoveBus("unknown"));
+    CHECK(catalogue.RemoveBus(LONG_NAME));
+    CHECK(!catalogue.GetBus(LONG_NAME));
+    CHECK(catalogue.GetStopBuses(catalogue.GetStop("A")).empty());
+    CHECK(catalogue.GetNamePoolStats().unique_strings == 2);
+    CHECK(catalogue.GetNamePoolStats().bytes_used == 2);
+
+    CHECK(catalogue.RemoveStop("B"));
+    CHECK(!catalogue.GetStop("B"));
+    CHECK(catalogue.GetStop("A"));
+    CHECK(catalogue.GetNamePoolStats().bytes_used == 1);
+}
+
+void TestStopUsedByBusIsNotRemoved() {
+    TransportCatalogue catalogue;
+    Stop* a = catalogue.AddStop("A", 55.611087, 37.20829);
+    Stop* b = catalogue.AddStop("B", 55.595884, 37.209755);
+    catalogue.AddBus("1", { a, b, a }, false);
+    bool thrown = false;
+    try {
+        catalogue.RemoveStop("A");
+    }
+    catch (const std::logic_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(catalogue.GetStop("A"));
+    CHECK(!catalogue.RemoveStop("unknown"));
+}
+
+// Новые координаты меняют географическую длину маршрута, а дорожная длина остаётся прежней
+void TestSetStopCoordinatesUpdatesCurvature() {
+    TransportCatalogue catalogue;
+    Stop* a = catalogue.AddStop("A", 55.611087, 37.20829);
+    Stop* b = catalogue.AddStop("B", 55.595884, 37.209755);
+    catalogue.AddDistanceBetweenStops(a, b, 5000);
+    catalogue.AddBus("1", { a, b, a }, false);
+    catalogue.Finalize();
+
+    catalogue.SetStopCoordinates("B", 55.574371, 37.6517);
+    const auto info = RequestHandler(catalogue).GetBusInfo("1");
+    CHECK(info);
+    CHECK(info->route_length == 10000);
+    const double geo_length = 2 * geo::ComputeDistance(a->coordinates, catalogue.GetStop("B")->coordinates);
+    CHECK(std::abs(info->curvature - 10000 / geo_length) < 1e-9);
+
+    // Рейтинг извилистости устарел и перестраивается только в Finalize()
+    bool thrown = false;
+    try {
+        catalogue.GetLayout().GetTopRanked(RankingMetric::CURVATURE, 1, 0.0, 1e9);
+    }
+    catch (const std::logic_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(catalogue.GetLayout().GetTopRanked(RankingMetric::STOP_COUNT, 1, 0.0, 1e9).size() == 1);
+    catalogue.Finalize();
+    const auto top = catalogue.GetLayout().GetTopRanked(RankingMetric::CURVATURE, 1, 0.0, 1e9);
+    CHECK(top.size() == 1);
+    CHECK(std::abs(top.front().value - info->curvature) < 1e-9);
+
+    thrown = false;
+    try {
+        catalogue.SetStopCoordinates("unknown", 0.0, 0.0);
+    }
+    catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+}
+
+int main() {
+    TestNamePoolCountsInternedBytes();
+    TestRemovedNamesLeaveThePool();
+    TestStopUsedByBusIsNotRemoved();
+    TestSetStopCoordinatesUpdatesCurvature();
+}
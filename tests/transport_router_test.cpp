@@ -0,0 +1,185 @@
+#include "test_utils.h"
+#include "transport_router.h"
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int STOP_COUNT = 24;
+constexpr int BUS_COUNT = 10;
+
+std::string StopName(int index) {
+    return "S" + std::to_string(index);
+}
+
+// Случайная сеть: у каждого перегона дорожное расстояние задано в одну или обе стороны
+void FillCatalogue(TransportCatalogue& catalogue, std::mt19937& random) {
+    for (int i = 0; i < STOP_COUNT; ++i) {
+        catalogue.AddStop(StopName(i), 55.6 + (random() % 1000) * 1e-4, 37.5 + (random() % 1000) * 1e-4);
+    }
+    for (int bus = 0; bus < BUS_COUNT; ++bus) {
+        const bool is_roundtrip = bus % 3 == 0;
+        std::vector<Stop*> stops;
+        const int stop_count = 3 + static_cast<int>(random() % 5);
+        while (static_cast<int>(stops.size()) < stop_count) {
+            Stop* stop = catalogue.GetStop(StopName(static_cast<int>(random() % STOP_COUNT)));
+            if (stops.empty() || stops.back() != stop) {
+                stops.push_back(stop);
+            }
+        }
+        if (is_roundtrip) {
+            stops.push_back(stops.front());
+        }
+        for (size_t i = 1; i < stops.size(); ++i) {
+            catalogue.AddDistanceBetweenStops(stops[i - 1], stops[i], 200 + static_cast<int>(random() % 3000));
+            if (random() % 2 == 0) {
+                catalogue.AddDistanceBetweenStops(stops[i], stops[i - 1], 200 + static_cast<int>(random() % 3000));
+            }
+        }
+        // Остановки некольцевого маршрута передаются развёрнутыми, как их передаёт JSON_Reader
+        if (!is_roundtrip) {
+            stops.insert(stops.end(), stops.rbegin() + 1, stops.rend());
+        }
+        catalogue.AddBus("B" + std::to_string(bus), stops, is_roundtrip);
+    }
+}
+
+// Маршрутизатор после точечных обновлений должен находить маршруты той же длительности, что и построенный заново.
+// Сами маршруты могут отличаться при равных по времени вариантах, но сумма их рёбер обязана совпадать с временем
+void CheckSameRoutes(TransportRouter& updated, TransportRouter& fresh) {
+    for (int from = 0; from < STOP_COUNT; ++from) {
+        for (int to = 0; to < STOP_COUNT; ++to) {
+            const auto expected = fresh.GetRoute(StopName(from), StopName(to));
+            const auto actual = updated.GetRoute(StopName(from), StopName(to));
+            CHECK(expected.has_value() == actual.has_value());
+            if (!actual) {
+                continue;
+            }
+            CHECK(std::abs(actual->time - expected->time) < 1e-6);
+            double edges_time = 0.0;
+            for (const auto& edge : actual->edges) {
+                edges_time += std::holds_alternative<BusEdge>(edge) ? std::get<BusEdge>(edge).ride_time : std::get<WaitEdge>(edge).wait_time;
+            }
+            CHECK(std::abs(edges_time - actual->time) < 1e-6);
+        }
+    }
+}
+
+void TestIncrementalUpdatesMatchRebuild() {
+    std::mt19937 random(27);
+    TransportCatalogue catalogue;
+    FillCatalogue(catalogue, random);
+    catalogue.Finalize();
+    int wait_time = 6;
+    double velocity = 40.0;
+    TransportRouter router(catalogue);
+    router.SetBusWaitTime(wait_time).SetBusVelocity(velocity);
+    // Первый запрос строит граф, дальше обновления чинят его на месте
+    router.GetRoute(StopName(0), StopName(1));
+
+    for (int update = 0; update < 60; ++update) {
+        const Bus& bus = catalogue.GetBuses()[random() % catalogue.GetBuses().size()];
+        const size_t index = random() % (bus.stops.size() - 1);
+        // Уменьшения и увеличения расстояний чинятся по-разному, поэтому встречаются и те и другие
+        router.UpdateRoadDistance(bus.stops[index]->name, bus.stops[index + 1]->name, 50 + static_cast<int>(random() % 5000));
+        if (update % 10 == 3) {
+            wait_time = 1 + static_cast<int>(random() % 10);
+            router.SetBusWaitTime(wait_time);
+        }
+        if (update % 10 == 7) {
+            velocity = 20.0 + static_cast<double>(random() % 40);
+            router.SetBusVelocity(velocity);
+        }
+        TransportRouter fresh(catalogue);
+        fresh.SetBusWaitTime(wait_time).SetBusVelocity(velocity);
+        CheckSameRoutes(router, fresh);
+    }
+}
+
+// Маршрут из from в to одной поездкой: ожидание и ребро поездки
+BusEdge GetSingleRide(const std::optional<RouteAndEdgesInfo>& route) {
+    CHECK(route);
+    CHECK(route->edges.size() == 2);
+    CHECK(std::holds_alternative<BusEdge>(route->edges[1]));
+    return std::get<BusEdge>(route->edges[1]);
+}
+
+// Из поездок между одной парой остановок в графе остаётся ребро самой короткой, при равенстве — с меньшим номером,
+// а после изменения расстояний ребро переходит к поездке, которая стала короче
+void TestParallelRidesAreCompacted() {
+    TransportCatalogue catalogue;
+    Stop* a = catalogue.AddStop("A", 55.60, 37.50);
+    Stop* b = catalogue.AddStop("B", 55.61, 37.51);
+    Stop* c = catalogue.AddStop("C", 55.62, 37.50);
+    catalogue.AddDistanceBetweenStops(a, b, 1000);
+    catalogue.AddDistanceBetweenStops(a, c, 400);
+    catalogue.AddDistanceBetweenStops(c, b, 600);
+    // Поездки маршрута X нумеруются раньше поездок Y. Из A в B обе поездки длиной 1000 м
+    catalogue.AddBus("X", { a, b, a }, true);
+    catalogue.AddBus("Y", { a, c, b, a }, true);
+    catalogue.Finalize();
+    TransportRouter router(catalogue);
+    router.SetBusWaitTime(1).SetBusVelocity(60.0);
+
+    const BusEdge tie = GetSingleRide(router.GetRoute("A", "B"));
+    CHECK(tie.bus_name == "X");
+    CHECK(tie.span_count == 1);
+    // По 3 поездки на каждые 3 остановки кольца X и 6 на 4 остановки Y;
+    // различных пар остановок шесть: A-B, A-A, B-A, A-C, C-B, C-A
+    CHECK(router.GetRideCount() == 9);
+    CHECK(router.GetRideEdgeCount() == 6);
+
+    router.UpdateRoadDistance("A", "C", 300);
+    const BusEdge shorter = GetSingleRide(router.GetRoute("A", "B"));
+    CHECK(shorter.bus_name == "Y");
+    CHECK(shorter.span_count == 2);
+    CHECK(std::abs(shorter.ride_time - 0.9) < 1e-9);
+
+    router.UpdateRoadDistance("A", "C", 500);
+    const BusEdge longer = GetSingleRide(router.GetRoute("A", "B"));
+    CHECK(longer.bus_name == "X");
+    CHECK(std::abs(longer.ride_time - 1.0) < 1e-9);
+    CHECK(router.GetRideEdgeCount() == 6);
+}
+
+// Число поездок и рёбер поездок попадает в сводку --stats
+void TestRouterCountsAreReported() {
+    const std::string input = R"({
+        "base_requests": [
+            {"type": "Bus", "name": "X", "stops": ["A", "B", "A"], "is_roundtrip": true},
+            {"type": "Bus", "name": "Y", "stops": ["A", "C", "B", "A"], "is_roundtrip": true},
+            {"type": "Stop", "name": "A", "latitude": 55.60, "longitude": 37.50, "road_distances": {"B": 1000, "C": 400}},
+            {"type": "Stop", "name": "B", "latitude": 55.61, "longitude": 37.51, "road_distances": {}},
+            {"type": "Stop", "name": "C", "latitude": 55.62, "longitude": 37.50, "road_distances": {"B": 600}}
+        ],
+        "routing_settings": {"bus_wait_time": 1, "bus_velocity": 60},
+        "stat_requests": [{"id": 1, "type": "Route", "from": "A", "to": "B"}]
+    })";
+    TransportCatalogue catalogue;
+    RequestHandler handler(catalogue);
+    json_reader::JSON_Reader reader;
+    std::istringstream in(input);
+    std::ostringstream out;
+    std::streambuf* cout_buffer = std::cout.rdbuf(out.rdbuf());
+    reader.ReadRequests(in, catalogue, handler);
+    std::cout.rdbuf(cout_buffer);
+
+    std::ostringstream stats;
+    reader.PrintStats(catalogue, stats);
+    std::istringstream stats_input(stats.str());
+    const json::Document report = json::Load(stats_input);
+    const auto& router = report.GetRoot().AsDict().at("router").AsDict();
+    CHECK(router.at("rides").AsInt() == 9);
+    CHECK(router.at("ride_edges").AsInt() == 6);
+}
+
+}
+
+int main() {
+    TestIncrementalUpdatesMatchRebuild();
+    TestParallelRidesAreCompacted();
+    TestRouterCountsAreReported();
+}
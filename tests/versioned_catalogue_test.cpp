@@ -0,0 +1,100 @@
+#include "test_utils.h"
+#include "versioned_catalogue.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int BACKWARD_DISTANCE = 500;
+constexpr int INITIAL_DISTANCE = 1000;
+
+TransportCatalogue MakeCatalogue() {
+    TransportCatalogue catalogue;
+    Stop* a = catalogue.AddStop("A", 55.611087, 37.20829);
+    Stop* b = catalogue.AddStop("B", 55.595884, 37.209755);
+    catalogue.AddDistanceBetweenStops(a, b, INITIAL_DISTANCE);
+    catalogue.AddDistanceBetweenStops(b, a, BACKWARD_DISTANCE);
+    // Остановки некольцевого маршрута передаются уже развёрнутыми: туда и обратно
+    catalogue.AddBus("1", { a, b, a }, false);
+    return catalogue;
+}
+
+// Писатель публикует версии с растущим расстоянием A -> B, читатели параллельно берут снимки.
+// Каждый снимок должен быть целой опубликованной версией: длина маршрута и рейтинг по длине согласованы,
+// а более поздний снимок того же потока не старше предыдущего
+void TestReadersSeeWholeVersions() {
+    constexpr int UPDATE_COUNT = 300;
+    constexpr int READER_COUNT = 3;
+    VersionedCatalogue versions(MakeCatalogue());
+    std::atomic<bool> writer_done = false;
+    std::atomic<long> read_count = 0;
+
+    std::vector<std::thread> readers;
+    for (int reader = 0; reader < READER_COUNT; ++reader) {
+        readers.emplace_back([&versions, &writer_done, &read_count] {
+            int last_length = 0;
+            while (!writer_done) {
+                const auto snapshot = versions.GetSnapshot();
+                const auto info = RequestHandler(*snapshot).GetBusInfo("1");
+                CHECK(info);
+                CHECK(info->route_length >= last_length);
+                CHECK(info->route_length >= INITIAL_DISTANCE + BACKWARD_DISTANCE);
+                CHECK(info->route_length < INITIAL_DISTANCE + UPDATE_COUNT + BACKWARD_DISTANCE);
+                const auto top = snapshot->GetLayout().GetTopRanked(RankingMetric::ROUTE_LENGTH, 1, 0, 1e9);
+                CHECK(top.size() == 1);
+                CHECK(top[0].value == info->route_length);
+                last_length = info->route_length;
+                ++read_count;
+            }
+        });
+    }
+
+    // Писатель уступает процессор, чтобы чтения перемежались с публикациями и на одном ядре
+    while (read_count == 0) {
+        std::this_thread::yield();
+    }
+    for (int update = 1; update < UPDATE_COUNT; ++update) {
+        versions.Update([update](TransportCatalogue& catalogue) {
+            catalogue.AddDistanceBetweenStops(catalogue.GetStop("A"), catalogue.GetStop("B"), INITIAL_DISTANCE + update);
+        });
+        std::this_thread::yield();
+    }
+    writer_done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    CHECK(read_count > 0);
+    const auto snapshot = versions.GetSnapshot();
+    CHECK(RequestHandler(*snapshot).GetBusInfo("1")->route_length == INITIAL_DISTANCE + UPDATE_COUNT - 1 + BACKWARD_DISTANCE);
+}
+
+void TestSnapshotLimitIsReported() {
+    VersionedCatalogue versions(MakeCatalogue());
+    std::vector<VersionedCatalogue::Snapshot> snapshots;
+    for (size_t i = 0; i < VersionedCatalogue::MAX_READERS; ++i) {
+        snapshots.push_back(versions.GetSnapshot());
+    }
+    bool thrown = false;
+    try {
+        versions.GetSnapshot();
+    }
+    catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    // Освобождённый слот снова доступен
+    snapshots.pop_back();
+    CHECK(versions.GetSnapshot()->GetStop("A"));
+}
+
+}
+
+int main() {
+    TestReadersSeeWholeVersions();
+    TestSnapshotLimitIsReported();
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace bits {
+
+// Номер младшего установленного бита, bits != 0
+inline int CountTrailingZeros(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bits);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    // Бит изолируется и ищется половинным делением
+    bits &= ~bits + 1;
+    int index = 0;
+    for (int shift = 32; shift > 0; shift /= 2) {
+        if ((bits >> shift) != 0) {
+            bits >>= shift;
+            index += shift;
+        }
+    }
+    return index;
+#endif
+}
+
+}
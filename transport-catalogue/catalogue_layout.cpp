@@ -0,0 +1,142 @@
+#include "catalogue_layout.h"
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace transport_catalogue
+{
+	std::pair<geo::Coordinates, geo::Coordinates> CatalogueLayout::GetStopBounds(const std::vector<uint32_t>& stop_ids) const {
+#ifdef TRANSPORT_CATALOGUE_FIXED_POINT_COORDINATES
+		// Границы ищутся по целым значениям и переводятся в градусы один раз
+		int32_t min_lat = stop_latitudes_[stop_ids.front()];
+		int32_t max_lat = min_lat;
+		int32_t min_lng = stop_longitudes_[stop_ids.front()];
+		int32_t max_lng = min_lng;
+		for (uint32_t stop_id : stop_ids) {
+			min_lat = std::min(min_lat, stop_latitudes_[stop_id]);
+			max_lat = std::max(max_lat, stop_latitudes_[stop_id]);
+			min_lng = std::min(min_lng, stop_longitudes_[stop_id]);
+			max_lng = std::max(max_lng, stop_longitudes_[stop_id]);
+		}
+		return { { geo::FromMicroDegrees(min_lat), geo::FromMicroDegrees(min_lng) },
+			{ geo::FromMicroDegrees(max_lat), geo::FromMicroDegrees(max_lng) } };
+#else
+		geo::Coordinates min_corner = stop_coordinates_[stop_ids.front()];
+		geo::Coordinates max_corner = min_corner;
+		for (uint32_t stop_id : stop_ids) {
+			const geo::Coordinates& coordinates = stop_coordinates_[stop_id];
+			min_corner = { std::min(min_corner.lat, coordinates.lat), std::min(min_corner.lng, coordinates.lng) };
+			max_corner = { std::max(max_corner.lat, coordinates.lat), std::max(max_corner.lng, coordinates.lng) };
+		}
+		return { min_corner, max_corner };
+#endif
+	}
+
+	std::vector<RankedItem> CatalogueLayout::GetTopRanked(RankingMetric metric, size_t limit, double min_value, double max_value) const {
+		using namespace std::literals;
+		if (stale_rankings_[static_cast<size_t>(metric)]) {
+			throw std::logic_error("Ranking is stale, catalogue is not finalized"s);
+		}
+		const Ranking& ranking = rankings_[static_cast<size_t>(metric)];
+		const bool is_stop_ranking = metric == RankingMetric::STOP_BUS_COUNT;
+		std::vector<RankedItem> result;
+		// Значения убывают, поэтому подходящие образуют отрезок, начало которого находится двоичным поиском
+		auto it = std::lower_bound(ranking.values.begin(), ranking.values.end(), max_value, std::greater<double>());
+		for (; it != ranking.values.end() && *it >= min_value && result.size() < limit; ++it) {
+			const uint32_t id = ranking.ids[it - ranking.values.begin()];
+			result.push_back({ is_stop_ranking ? GetStopName(id) : GetBusName(id), *it });
+		}
+		return result;
+	}
+
+	void CatalogueLayout::BuildRanking(RankingMetric metric) {
+		std::vector<std::pair<double, uint32_t>> entries;
+		if (metric == RankingMetric::STOP_BUS_COUNT) {
+			entries.reserve(GetStopCount());
+			for (uint32_t stop_id = 0; stop_id < GetStopCount(); ++stop_id) {
+				entries.emplace_back(static_cast<double>(GetStopBuses(stop_id).size()), stop_id);
+			}
+		}
+		else {
+			entries.reserve(GetBusCount());
+			for (uint32_t bus_id = 0; bus_id < GetBusCount(); ++bus_id) {
+				const size_t stop_count = GetBusStops(bus_id).size();
+				if (stop_count == 0) {
+					continue;
+				}
+				switch (metric) {
+				case RankingMetric::ROUTE_LENGTH:
+					if (bus_has_road_distances_[bus_id]) {
+						entries.emplace_back(GetRouteDistance(bus_id), bus_id);
+					}
+					break;
+				case RankingMetric::CURVATURE:
+					if (bus_has_road_distances_[bus_id]) {
+						entries.emplace_back(GetRouteDistance(bus_id) / GetGeoRouteDistance(bus_id), bus_id);
+					}
+					break;
+				case RankingMetric::STOP_COUNT:
+					entries.emplace_back(static_cast<double>(stop_count), bus_id);
+					break;
+				case RankingMetric::UNIQUE_STOP_COUNT:
+					entries.emplace_back(GetUniqueStopCount(bus_id), bus_id);
+					break;
+				case RankingMetric::STOP_BUS_COUNT:
+					break;
+				}
+			}
+		}
+		const std::vector<std::string_view>& names = metric == RankingMetric::STOP_BUS_COUNT ? stop_names_ : bus_names_;
+		std::sort(entries.begin(), entries.end(), [&names](const auto& lhs, const auto& rhs) {
+			if (lhs.first != rhs.first) {
+				return lhs.first > rhs.first;
+			}
+			return names[lhs.second] < names[rhs.second];
+		});
+
+		Ranking& ranking = rankings_[static_cast<size_t>(metric)];
+		ranking.ids.clear();
+		ranking.values.clear();
+		ranking.ids.reserve(entries.size());
+		ranking.values.reserve(entries.size());
+		for (const auto& [value, id] : entries) {
+			ranking.values.push_back(value);
+			ranking.ids.push_back(id);
+		}
+		stale_rankings_[static_cast<size_t>(metric)] = false;
+	}
+
+	void CatalogueLayout::BuildRankings() {
+		for (size_t metric = 0; metric < rankings_.size(); ++metric) {
+			BuildRanking(static_cast<RankingMetric>(metric));
+		}
+	}
+
+	void CatalogueLayout::BuildStaleRankings() {
+		for (size_t metric = 0; metric < rankings_.size(); ++metric) {
+			if (stale_rankings_[metric]) {
+				BuildRanking(static_cast<RankingMetric>(metric));
+			}
+		}
+	}
+
+	void CatalogueLayout::AddStopCoordinates(geo::Coordinates coordinates) {
+#ifdef TRANSPORT_CATALOGUE_FIXED_POINT_COORDINATES
+		stop_latitudes_.push_back(geo::ToMicroDegrees(coordinates.lat));
+		stop_longitudes_.push_back(geo::ToMicroDegrees(coordinates.lng));
+#else
+		stop_coordinates_.push_back(coordinates);
+#endif
+	}
+
+	void CatalogueLayout::SetStopCoordinates(uint32_t stop_id, geo::Coordinates coordinates) {
+#ifdef TRANSPORT_CATALOGUE_FIXED_POINT_COORDINATES
+		stop_latitudes_[stop_id] = geo::ToMicroDegrees(coordinates.lat);
+		stop_longitudes_[stop_id] = geo::ToMicroDegrees(coordinates.lng);
+#else
+		stop_coordinates_[stop_id] = coordinates;
+#endif
+	}
+}
@@ -0,0 +1,159 @@
+#pragma once
+#include "geo.h"
+#include "ranges.h"
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace transport_catalogue
+{
+    // Показатели, по которым справочник поддерживает рейтинги маршрутов и остановок
+    enum class RankingMetric {
+        ROUTE_LENGTH,
+        CURVATURE,
+        STOP_COUNT,
+        UNIQUE_STOP_COUNT,
+        // Число маршрутов через остановку
+        STOP_BUS_COUNT,
+    };
+
+    struct RankedItem {
+        std::string_view name;
+        double value;
+    };
+
+    // Представление справочника для запросов, которое строит TransportCatalogue::Finalize().
+    // Данные остановок и маршрутов лежат в плоских массивах, индексируемых их номерами в справочнике.
+    // Последовательности переменной длины уложены подряд в общий массив, i-я занимает отрезок [offsets[i], offsets[i + 1]).
+    // Имена ссылаются на пул строк справочника.
+    // С TRANSPORT_CATALOGUE_FIXED_POINT_COORDINATES координаты остановок хранятся целыми микроградусами
+    // в отдельных массивах широт и долгот: 8 байт на остановку вместо 16 ценой округления до 0,5 микроградуса.
+    class CatalogueLayout {
+    public:
+        using IdRange = ranges::Range<std::vector<uint32_t>::const_iterator>;
+        using NameRange = ranges::Range<std::vector<std::string_view>::const_iterator>;
+        using DistanceRange = ranges::Range<std::vector<int>::const_iterator>;
+
+        size_t GetStopCount() const {
+            return stop_names_.size();
+        }
+        std::string_view GetStopName(uint32_t stop_id) const {
+            return stop_names_[stop_id];
+        }
+        geo::Coordinates GetStopCoordinates(uint32_t stop_id) const {
+#ifdef TRANSPORT_CATALOGUE_FIXED_POINT_COORDINATES
+            return { geo::FromMicroDegrees(stop_latitudes_[stop_id]), geo::FromMicroDegrees(stop_longitudes_[stop_id]) };
+#else
+            return stop_coordinates_[stop_id];
+#endif
+        }
+        // Наименьшие и наибольшие широта и долгота среди остановок stop_ids; набор не должен быть пустым
+        std::pair<geo::Coordinates, geo::Coordinates> GetStopBounds(const std::vector<uint32_t>& stop_ids) const;
+        // Маршруты через остановку в порядке названий
+        IdRange GetStopBuses(uint32_t stop_id) const {
+            return { stop_bus_ids_.begin() + stop_bus_offsets_[stop_id], stop_bus_ids_.begin() + stop_bus_offsets_[stop_id + 1] };
+        }
+        NameRange GetStopBusNames(uint32_t stop_id) const {
+            return { stop_bus_names_.begin() + stop_bus_offsets_[stop_id], stop_bus_names_.begin() + stop_bus_offsets_[stop_id + 1] };
+        }
+
+        size_t GetBusCount() const {
+            return bus_names_.size();
+        }
+        std::string_view GetBusName(uint32_t bus_id) const {
+            return bus_names_[bus_id];
+        }
+        bool IsRoundtrip(uint32_t bus_id) const {
+            return bus_is_roundtrip_[bus_id];
+        }
+        // Остановки маршрута в порядке следования
+        IdRange GetBusStops(uint32_t bus_id) const {
+            return { route_stop_ids_.begin() + bus_stop_offsets_[bus_id], route_stop_ids_.begin() + bus_stop_offsets_[bus_id + 1] };
+        }
+        int GetUniqueStopCount(uint32_t bus_id) const {
+            return unique_stop_counts_[bus_id];
+        }
+        // Накопленные дорожные расстояния от первой остановки маршрута до каждой из его остановок
+        DistanceRange GetRoadDistancePrefix(uint32_t bus_id) const {
+            using namespace std::literals;
+            if (!bus_has_road_distances_[bus_id]) {
+                throw std::out_of_range("Road distance is not set"s);
+            }
+            return { road_distance_prefix_.begin() + bus_stop_offsets_[bus_id], road_distance_prefix_.begin() + bus_stop_offsets_[bus_id + 1] };
+        }
+        // Дорожное расстояние между остановками маршрута с индексами from_index <= to_index
+        int GetSegmentDistance(uint32_t bus_id, size_t from_index, size_t to_index) const {
+            const DistanceRange prefix = GetRoadDistancePrefix(bus_id);
+            return prefix.begin()[to_index] - prefix.begin()[from_index];
+        }
+        int GetRouteDistance(uint32_t bus_id) const {
+            return GetSegmentDistance(bus_id, 0, GetBusStops(bus_id).size() - 1);
+        }
+        double GetGeoRouteDistance(uint32_t bus_id) const {
+            return geo_distance_prefix_[bus_stop_offsets_[bus_id + 1] - 1];
+        }
+
+        // Номера в порядке сравнения Stop::operator< и Bus::operator<, в котором объекты рисуются на карте
+        const std::vector<uint32_t>& GetStopsByName() const {
+            return stops_by_name_;
+        }
+        const std::vector<uint32_t>& GetBusesByName() const {
+            return buses_by_name_;
+        }
+
+        // Не более limit маршрутов (для STOP_BUS_COUNT — остановок) со значением показателя в [min_value, max_value],
+        // по убыванию значения, при равенстве — в порядке названий. Непустые маршруты без дорожных расстояний
+        // в рейтинги длины и извилистости не входят. Работает за O(log n + limit). Рейтинги длины и извилистости
+        // устаревают после изменения расстояний или координат и перестраиваются в TransportCatalogue::Finalize();
+        // запрос устаревшего рейтинга бросает std::logic_error.
+        std::vector<RankedItem> GetTopRanked(RankingMetric metric, size_t limit, double min_value, double max_value) const;
+
+    private:
+        friend class TransportCatalogue;
+
+        // Номера, упорядоченные по убыванию значения показателя, и сами значения
+        struct Ranking {
+            std::vector<uint32_t> ids;
+            std::vector<double> values;
+        };
+
+        void BuildRanking(RankingMetric metric);
+        void BuildRankings();
+        void BuildStaleRankings();
+        void MarkRankingStale(RankingMetric metric) {
+            stale_rankings_[static_cast<size_t>(metric)] = true;
+        }
+        void AddStopCoordinates(geo::Coordinates coordinates);
+        void SetStopCoordinates(uint32_t stop_id, geo::Coordinates coordinates);
+
+        std::vector<std::string_view> stop_names_;
+#ifdef TRANSPORT_CATALOGUE_FIXED_POINT_COORDINATES
+        std::vector<int32_t> stop_latitudes_;
+        std::vector<int32_t> stop_longitudes_;
+#else
+        std::vector<geo::Coordinates> stop_coordinates_;
+#endif
+        std::vector<uint32_t> stop_bus_offsets_;
+        std::vector<uint32_t> stop_bus_ids_;
+        std::vector<std::string_view> stop_bus_names_;
+        std::vector<uint32_t> stops_by_name_;
+
+        std::vector<std::string_view> bus_names_;
+        std::vector<bool> bus_is_roundtrip_;
+        std::vector<bool> bus_has_road_distances_;
+        std::vector<int> unique_stop_counts_;
+        std::vector<uint32_t> bus_stop_offsets_;
+        // Массивы, параллельные остановкам всех маршрутов подряд
+        std::vector<uint32_t> route_stop_ids_;
+        std::vector<int> road_distance_prefix_;
+        std::vector<double> geo_distance_prefix_;
+        std::vector<uint32_t> buses_by_name_;
+
+        static constexpr size_t RANKING_COUNT = static_cast<size_t>(RankingMetric::STOP_BUS_COUNT) + 1;
+        std::array<Ranking, RANKING_COUNT> rankings_;
+        std::array<bool, RANKING_COUNT> stale_rankings_ = {};
+    };
+}
@@ -1,13 +1,16 @@
 #pragma once
 #include "geo.h"
-#include <string>
+#include <cstdint>
+#include <string_view>
 #include <vector>
 
 namespace domain
 {
     struct Stop {
-        std::string name;
+        std::string_view name;
         geo::Coordinates coordinates = { 0.0, 0.0 };
+        // Порядковый номер остановки в справочнике
+        uint32_t id = 0;
 
         bool operator<(const Stop& rhs) const noexcept {
             return std::lexicographical_compare(this->name.begin(), this->name.end(), rhs.name.begin(), rhs.name.end());
@@ -15,9 +18,15 @@ namespace domain
     };
 
     struct Bus {
-        std::string bus_num;
+        std::string_view bus_num;
         std::vector<Stop*> stops;
         bool is_roundtrip = false;
+        // Порядковый номер маршрута в справочнике
+        uint32_t id = 0;
+        // Накопленные расстояния от первой остановки маршрута до каждой из его остановок.
+        // Дорожные расстояния пусты, если для какого-либо перегона расстояние не задано.
+        std::vector<int> road_distance_prefix = {};
+        std::vector<double> geo_distance_prefix = {};
 
         bool operator<(const Bus& rhs) const noexcept {
             return std::lexicographical_compare(this->bus_num.begin(), this->bus_num.end(), rhs.bus_num.begin(), rhs.bus_num.end());
@@ -1,4 +1,6 @@
 #pragma once
+#include <cmath>
+#include <cstdint>
 
 const int EARTH_RADIUS = 6371000;
 
@@ -18,4 +20,12 @@ struct Coordinates {
 
 double ComputeDistance(Coordinates from, Coordinates to);
 
+// Координата в целых микроградусах: шаг около 11 см, диапазон int32 покрывает ±180 градусов
+inline int32_t ToMicroDegrees(double degrees) {
+    return static_cast<int32_t>(std::lround(degrees * 1e6));
+}
+inline double FromMicroDegrees(int32_t micro_degrees) {
+    return micro_degrees / 1e6;
+}
+
 }
\ No newline at end of file
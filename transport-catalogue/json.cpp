@@ -1,13 +1,15 @@
 #include "json.h"
 
+#include <charconv>
 #include <iterator>
+#include <memory_resource>
 
 namespace json {
 
 namespace {
 using namespace std::literals;
 
-Node LoadNode(std::istream& input);
+Node LoadNode(std::istream& input, std::pmr::memory_resource* resource);
 Node LoadString(std::istream& input);
 
 std::string LoadLiteral(std::istream& input) {
@@ -18,14 +20,14 @@ std::string LoadLiteral(std::istream& input) {
     return s;
 }
 
-Node LoadArray(std::istream& input) {
-    std::vector<Node> result;
+Node LoadArray(std::istream& input, std::pmr::memory_resource* resource) {
+    Array result(resource);
 
     for (char c; input >> c && c != ']';) {
         if (c != ',') {
             input.putback(c);
         }
-        result.push_back(LoadNode(input));
+        result.push_back(LoadNode(input, resource));
     }
     if (!input) {
         throw ParsingError("Array parsing error"s);
@@ -33,17 +35,17 @@ Node LoadArray(std::istream& input) {
     return Node(std::move(result));
 }
 
-Node LoadDict(std::istream& input) {
-    Dict dict;
+Node LoadDict(std::istream& input, std::pmr::memory_resource* resource) {
+    Dict dict(resource);
 
     for (char c; input >> c && c != '}';) {
         if (c == '"') {
-            std::string key = LoadString(input).AsString();
+            std::string key{ LoadString(input).AsString() };
             if (input >> c && c == ':') {
                 if (dict.find(key) != dict.end()) {
                     throw ParsingError("Duplicate key '"s + key + "' have been found");
                 }
-                dict.emplace(std::move(key), LoadNode(input));
+                dict.emplace(std::move(key), LoadNode(input, resource));
             } else {
                 throw ParsingError(": is expected but '"s + c + "' has been found"s);
             }
@@ -174,32 +176,33 @@ Node LoadNumber(std::istream& input) {
         is_int = false;
     }
 
-    try {
-        if (is_int) {
-            // Сначала пробуем преобразовать строку в int
-            try {
-                return std::stoi(parsed_num);
-            } catch (...) {
-                // В случае неудачи, например, при переполнении
-                // код ниже попробует преобразовать строку в double
-            }
+    // from_chars не зависит от локали и не бросает исключений
+    const char* first = parsed_num.data();
+    const char* last = first + parsed_num.size();
+    if (is_int) {
+        int int_value = 0;
+        if (auto [ptr, ec] = std::from_chars(first, last, int_value); ec == std::errc{} && ptr == last) {
+            return int_value;
         }
-        return std::stod(parsed_num);
-    } catch (...) {
+        // При переполнении int код ниже преобразует строку в double
+    }
+    double double_value = 0.0;
+    if (auto [ptr, ec] = std::from_chars(first, last, double_value); ec != std::errc{} || ptr != last) {
         throw ParsingError("Failed to convert "s + parsed_num + " to number"s);
     }
+    return double_value;
 }
 
-Node LoadNode(std::istream& input) {
+Node LoadNode(std::istream& input, std::pmr::memory_resource* resource) {
     char c;
     if (!(input >> c)) {
         throw ParsingError("Unexpected EOF"s);
     }
     switch (c) {
         case '[':
-            return LoadArray(input);
+            return LoadArray(input, resource);
         case '{':
-            return LoadDict(input);
+            return LoadDict(input, resource);
         case '"':
             return LoadString(input);
         case 't':
@@ -222,54 +225,137 @@ Node LoadNode(std::istream& input) {
     }
 }
 
+// Буферизованный вывод: документ печатается множеством мелких фрагментов,
+// поэтому они накапливаются в буфере и передаются в поток крупными блоками
+class Writer {
+public:
+    explicit Writer(std::ostream& out)
+        : out_(out) {
+        buffer_.reserve(BUFFER_SIZE);
+    }
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    void Put(char c) {
+        buffer_.push_back(c);
+        FlushIfFull();
+    }
+
+    // Большие фрагменты, например текст карты, передаются в поток напрямую, минуя буфер
+    void Write(std::string_view text) {
+        if (text.size() >= BUFFER_SIZE) {
+            Flush();
+            out_.write(text.data(), text.size());
+            return;
+        }
+        buffer_.append(text);
+        FlushIfFull();
+    }
+
+    void Fill(size_t count, char c) {
+        buffer_.append(count, c);
+        FlushIfFull();
+    }
+
+    void Flush() {
+        out_.write(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+
+private:
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+    void FlushIfFull() {
+        if (buffer_.size() >= BUFFER_SIZE) {
+            Flush();
+        }
+    }
+
+    std::ostream& out_;
+    std::string buffer_;
+};
+
 struct PrintContext {
-    std::ostream& out;
+    Writer& out;
+    PrintMode mode = PrintMode::PRETTY;
     int indent_step = 4;
     int indent = 0;
 
     void PrintIndent() const {
-        for (int i = 0; i < indent; ++i) {
-            out.put(' ');
+        if (mode == PrintMode::PRETTY) {
+            out.Fill(indent, ' ');
         }
     }
 
+    void PrintNewLine() const {
+        if (mode == PrintMode::PRETTY) {
+            out.Put('\n');
+        }
+    }
+
+    void PrintKeySeparator() const {
+        out.Write(mode == PrintMode::PRETTY ? ": "sv : ":"sv);
+    }
+
     PrintContext Indented() const {
-        return {out, indent_step, indent_step + indent};
+        return {out, mode, indent_step, indent_step + indent};
     }
 };
 
 void PrintNode(const Node& value, const PrintContext& ctx);
 
 template <typename Value>
-void PrintValue(const Value& value, const PrintContext& ctx) {
-    ctx.out << value;
-}
-
-void PrintString(const std::string& value, std::ostream& out) {
-    out.put('"');
-    for (const char c : value) {
-        switch (c) {
+void PrintValue(const Value& value, const PrintContext& ctx);
+
+// Участки строки без спецсимволов копируются целиком
+void PrintString(std::string_view value, Writer& out) {
+    out.Put('"');
+    size_t plain_begin = 0;
+    for (size_t i = 0; i < value.size(); ++i) {
+        std::string_view escaped;
+        switch (value[i]) {
             case '\r':
-                out << "\\r"sv;
+                escaped = "\\r"sv;
                 break;
             case '\n':
-                out << "\\n"sv;
+                escaped = "\\n"sv;
                 break;
             case '\t':
-                out << "\\t"sv;
+                escaped = "\\t"sv;
                 break;
             case '"':
                 // Символы " и \ выводятся как \" или \\, соответственно
-                [[fallthrough]];
+                escaped = "\\\""sv;
+                break;
             case '\\':
-                out.put('\\');
-                [[fallthrough]];
-            default:
-                out.put(c);
+                escaped = "\\\\"sv;
                 break;
+            default:
+                continue;
         }
+        out.Write(value.substr(plain_begin, i - plain_begin));
+        out.Write(escaped);
+        plain_begin = i + 1;
     }
-    out.put('"');
+    out.Write(value.substr(plain_begin));
+    out.Put('"');
+}
+
+// Числа выводятся через to_chars без обращения к локали потока.
+// Для double используется формат %g с точностью 6, как у operator<< по умолчанию
+template <>
+void PrintValue<int>(const int& value, const PrintContext& ctx) {
+    char buffer[16];
+    const auto result = std::to_chars(std::begin(buffer), std::end(buffer), value);
+    ctx.out.Write({buffer, static_cast<size_t>(result.ptr - buffer)});
+}
+
+template <>
+void PrintValue<double>(const double& value, const PrintContext& ctx) {
+    char buffer[32];
+    const auto result = std::to_chars(std::begin(buffer), std::end(buffer), value, std::chars_format::general, 6);
+    ctx.out.Write({buffer, static_cast<size_t>(result.ptr - buffer)});
 }
 
 template <>
@@ -277,9 +363,14 @@ void PrintValue<std::string>(const std::string& value, const PrintContext& ctx)
     PrintString(value, ctx.out);
 }
 
+template <>
+void PrintValue<std::string_view>(const std::string_view& value, const PrintContext& ctx) {
+    PrintString(value, ctx.out);
+}
+
 template <>
 void PrintValue<std::nullptr_t>(const std::nullptr_t&, const PrintContext& ctx) {
-    ctx.out << "null"sv;
+    ctx.out.Write("null"sv);
 }
 
 // В специализации шаблона PrintValue для типа bool параметр value передаётся
@@ -288,49 +379,53 @@ void PrintValue<std::nullptr_t>(const std::nullptr_t&, const PrintContext& ctx)
 // void PrintValue(bool value, const PrintContext& ctx);
 template <>
 void PrintValue<bool>(const bool& value, const PrintContext& ctx) {
-    ctx.out << (value ? "true"sv : "false"sv);
+    ctx.out.Write(value ? "true"sv : "false"sv);
 }
 
 template <>
 void PrintValue<Array>(const Array& nodes, const PrintContext& ctx) {
-    std::ostream& out = ctx.out;
-    out << "[\n"sv;
+    Writer& out = ctx.out;
+    out.Put('[');
+    ctx.PrintNewLine();
     bool first = true;
     auto inner_ctx = ctx.Indented();
     for (const Node& node : nodes) {
         if (first) {
             first = false;
         } else {
-            out << ",\n"sv;
+            out.Put(',');
+            ctx.PrintNewLine();
         }
         inner_ctx.PrintIndent();
         PrintNode(node, inner_ctx);
     }
-    out.put('\n');
+    ctx.PrintNewLine();
     ctx.PrintIndent();
-    out.put(']');
+    out.Put(']');
 }
 
 template <>
 void PrintValue<Dict>(const Dict& nodes, const PrintContext& ctx) {
-    std::ostream& out = ctx.out;
-    out << "{\n"sv;
+    Writer& out = ctx.out;
+    out.Put('{');
+    ctx.PrintNewLine();
     bool first = true;
     auto inner_ctx = ctx.Indented();
     for (const auto& [key, node] : nodes) {
         if (first) {
             first = false;
         } else {
-            out << ",\n"sv;
+            out.Put(',');
+            ctx.PrintNewLine();
         }
         inner_ctx.PrintIndent();
         PrintString(key, ctx.out);
-        out << ": "sv;
+        ctx.PrintKeySeparator();
         PrintNode(node, inner_ctx);
     }
-    out.put('\n');
+    ctx.PrintNewLine();
     ctx.PrintIndent();
-    out.put('}');
+    out.Put('}');
 }
 
 void PrintNode(const Node& node, const PrintContext& ctx) {
@@ -344,11 +439,15 @@ void PrintNode(const Node& node, const PrintContext& ctx) {
 }  // namespace
 
 Document Load(std::istream& input) {
-    return Document{LoadNode(input)};
+    auto arena = std::make_unique<std::pmr::monotonic_buffer_resource>();
+    Node root = LoadNode(input, arena.get());
+    return Document{std::move(arena), std::move(root)};
 }
 
-void Print(const Document& doc, std::ostream& output) {
-    PrintNode(doc.GetRoot(), PrintContext{output});
+void Print(const Document& doc, std::ostream& output, PrintMode mode) {
+    Writer writer(output);
+    PrintNode(doc.GetRoot(), PrintContext{writer, mode});
+    writer.Flush();
 }
 
 }  // namespace json
\ No newline at end of file
@@ -1,29 +1,80 @@
 #pragma once
 
+#include <algorithm>
 #include <iostream>
-#include <map>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
 namespace json {
 
 class Node;
-using Dict = std::map<std::string, Node>;
-using Array = std::vector<Node>;
+// Узлы массивов и словарей размещаются в ресурсе памяти документа и освобождаются вместе с ним
+using Array = std::pmr::vector<Node>;
+
+// Словарь в виде отсортированного по ключу вектора пар: один блок памяти вместо узла дерева на каждый ключ.
+// Короткие ключи и строковые значения хранятся внутри std::string без отдельного выделения памяти.
+class Dict {
+public:
+    using value_type = std::pair<std::string, Node>;
+    using Storage = std::pmr::vector<value_type>;
+    using allocator_type = Storage::allocator_type;
+    using const_iterator = Storage::const_iterator;
+
+    Dict() = default;
+    explicit Dict(const allocator_type& allocator)
+        : items_(allocator) {
+    }
+
+    Node& operator[](std::string key);
+    const Node& at(std::string_view key) const;
+    const_iterator find(std::string_view key) const;
+    size_t count(std::string_view key) const;
+    std::pair<const_iterator, bool> emplace(std::string key, Node value);
+
+    const_iterator begin() const {
+        return items_.begin();
+    }
+    const_iterator end() const {
+        return items_.end();
+    }
+    size_t size() const {
+        return items_.size();
+    }
+    bool empty() const {
+        return items_.empty();
+    }
+
+    bool operator==(const Dict& rhs) const;
+
+private:
+    Storage::iterator LowerBound(std::string_view key);
+    Storage::const_iterator LowerBound(std::string_view key) const;
+
+    Storage items_;
+};
 
 class ParsingError : public std::runtime_error {
 public:
     using runtime_error::runtime_error;
 };
 
+// Строка хранится либо в самом узле (std::string), либо во внешнем хранилище (std::string_view).
+// Вторым вариантом ответы ссылаются на имена из справочника без копирования; хранилище должно пережить узел.
 class Node final
-    : private std::variant<std::nullptr_t, Array, Dict, bool, int, double, std::string> {
+    : private std::variant<std::nullptr_t, Array, Dict, bool, int, double, std::string, std::string_view> {
 public:
     using variant::variant;
 	using Value = variant;
     
     Node(Value value) : variant(std::move(value)) {}
+    // Строка в стиле C копируется в узел; чтобы сослаться на неё без копирования, нужно передать std::string_view
+    Node(const char* value) : variant(std::string(value)) {}
 
     bool IsInt() const {
         return std::holds_alternative<int>(*this);
@@ -79,15 +130,17 @@ public:
     }
 
     bool IsString() const {
-        return std::holds_alternative<std::string>(*this);
+        return std::holds_alternative<std::string>(*this) || std::holds_alternative<std::string_view>(*this);
     }
-    const std::string& AsString() const {
+    std::string_view AsString() const {
         using namespace std::literals;
-        if (!IsString()) {
-            throw std::logic_error("Not a string"s);
+        if (const auto* value = std::get_if<std::string>(this)) {
+            return *value;
         }
-
-        return std::get<std::string>(*this);
+        if (const auto* value = std::get_if<std::string_view>(this)) {
+            return *value;
+        }
+        throw std::logic_error("Not a string"s);
     }
 
     bool IsDict() const {
@@ -102,7 +155,11 @@ public:
         return std::get<Dict>(*this);
     }
 
+    // Строки сравниваются по содержимому независимо от способа хранения
     bool operator==(const Node& rhs) const {
+        if (IsString() && rhs.IsString()) {
+            return AsString() == rhs.AsString();
+        }
         return GetValue() == rhs.GetValue();
     }
 
@@ -118,17 +175,87 @@ inline bool operator!=(const Node& lhs, const Node& rhs) {
     return !(lhs == rhs);
 }
 
+inline Dict::Storage::const_iterator Dict::LowerBound(std::string_view key) const {
+    return std::lower_bound(items_.begin(), items_.end(), key, [](const value_type& item, std::string_view key) {
+        return item.first < key;
+    });
+}
+
+inline Dict::Storage::iterator Dict::LowerBound(std::string_view key) {
+    return items_.begin() + (std::as_const(*this).LowerBound(key) - items_.cbegin());
+}
+
+inline Node& Dict::operator[](std::string key) {
+    auto it = LowerBound(key);
+    if (it == items_.end() || it->first != key) {
+        it = items_.emplace(it, std::move(key), Node{});
+    }
+    return it->second;
+}
+
+inline Dict::const_iterator Dict::find(std::string_view key) const {
+    auto it = LowerBound(key);
+    if (it == items_.end() || it->first != key) {
+        return items_.end();
+    }
+    return it;
+}
+
+inline const Node& Dict::at(std::string_view key) const {
+    using namespace std::literals;
+    if (auto it = find(key); it != end()) {
+        return it->second;
+    }
+    throw std::out_of_range("Key '"s + std::string(key) + "' not found"s);
+}
+
+inline size_t Dict::count(std::string_view key) const {
+    return find(key) != end() ? 1 : 0;
+}
+
+inline std::pair<Dict::const_iterator, bool> Dict::emplace(std::string key, Node value) {
+    auto it = LowerBound(key);
+    if (it != items_.end() && it->first == key) {
+        return { it, false };
+    }
+    return { items_.emplace(it, std::move(key), std::move(value)), true };
+}
+
+inline bool Dict::operator==(const Dict& rhs) const {
+    return std::equal(items_.begin(), items_.end(), rhs.items_.begin(), rhs.items_.end());
+}
+
 class Document {
 public:
     explicit Document(Node root)
         : root_(std::move(root)) {
     }
 
+    // Документ владеет ресурсом памяти, в котором размещены узлы root
+    Document(std::unique_ptr<std::pmr::memory_resource> arena, Node root)
+        : arena_(std::move(arena))
+        , root_(std::move(root)) {
+    }
+
+    Document(const Document& other)
+        : root_(other.root_) {
+    }
+    Document(Document&& other) = default;
+
+    Document& operator=(Document other) {
+        // Узлы освобождаются до ресурса, в котором они размещены
+        root_ = Node{};
+        arena_ = std::move(other.arena_);
+        root_ = std::move(other.root_);
+        return *this;
+    }
+
     const Node& GetRoot() const {
         return root_;
     }
 
 private:
+    std::unique_ptr<std::pmr::memory_resource> arena_;
     Node root_;
 };
 
@@ -142,6 +269,12 @@ inline bool operator!=(const Document& lhs, const Document& rhs) {
 
 Document Load(std::istream& input);
 
-void Print(const Document& doc, std::ostream& output);
+// PRETTY — многострочный вывод с отступами в 4 пробела, COMPACT — без пробельных символов
+enum class PrintMode {
+    PRETTY,
+    COMPACT
+};
+
+void Print(const Document& doc, std::ostream& output, PrintMode mode = PrintMode::PRETTY);
 
 }  // namespace json
\ No newline at end of file
@@ -8,7 +8,12 @@ using namespace std::literals;
 namespace json {
 
     Builder::Builder()
-        : root_()
+        : Builder(std::pmr::get_default_resource())
+    {}
+
+    Builder::Builder(std::pmr::memory_resource* resource)
+        : resource_(resource)
+        , root_()
         , nodes_stack_{ &root_ }
     {}
 
@@ -38,12 +43,12 @@ namespace json {
     }
 
     Builder::DictItemContext Builder::StartDict() {
-        AddObject(Dict{}, false);
+        AddObject(Dict(resource_), false);
         return BaseContext{ *this };
     }
 
     Builder::ArrayItemContext Builder::StartArray() {
-        AddObject(Array{}, false);
+        AddObject(Array(resource_), false);
         return BaseContext{ *this };
     }
 
@@ -63,15 +68,19 @@ namespace json {
         return *this;
     }
 
-    Node::Value& Builder::GetCurrentValue() {
+    Node& Builder::GetCurrentNode() const {
         if (nodes_stack_.empty()) {
             throw std::logic_error("Attempt to change finalized JSON"s);
         }
-        return nodes_stack_.back()->GetValue();
+        return *nodes_stack_.back();
+    }
+
+    Node::Value& Builder::GetCurrentValue() {
+        return GetCurrentNode().GetValue();
     }
 
     const Node::Value& Builder::GetCurrentValue() const {
-        return const_cast<Builder*>(this)->GetCurrentValue();
+        return GetCurrentNode().GetValue();
     }
 
     void Builder::AssertNewObjectContext() const {
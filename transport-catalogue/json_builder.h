@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory_resource>
 #include <string>
 #include <vector>
 #include "json.h"
@@ -15,6 +16,8 @@ namespace json {
 
     public:
         Builder();
+        // Массивы и словари создаются в указанном ресурсе памяти, который должен пережить результат
+        explicit Builder(std::pmr::memory_resource* resource);
         Node Build();
         DictValueContext Key(std::string key);
         BaseContext Value(Node::Value value);
@@ -24,9 +27,12 @@ namespace json {
         BaseContext EndArray();
 
     private:
+        std::pmr::memory_resource* resource_;
         Node root_;
         std::vector<Node*> nodes_stack_;
 
+        // Узлы в стеке принадлежат строителю и изменяемы независимо от константности доступа к нему
+        Node& GetCurrentNode() const;
         Node::Value& GetCurrentValue();
         const Node::Value& GetCurrentValue() const;
 
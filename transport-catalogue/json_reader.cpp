@@ -1,102 +1,385 @@
 #include "json_reader.h"
 namespace json_reader {
 
-void JSON_Reader::ReadRequests(std::istream& input, TransportCatalogue& catalogue, RequestHandler& handler, MapRenderer& map_renderer, TransportRouter& router) {
-	const Document& doc = Load(input);
-	const Node& doc_root = doc.GetRoot();
+namespace {
+
+// Буфер потока, дописывающий вывод в строку: текст карты затем перемещается в ответ без копирования
+class StringAppendBuffer : public std::streambuf {
+public:
+	explicit StringAppendBuffer(std::string& target)
+		: target_(target) {
+	}
+
+protected:
+	int_type overflow(int_type c) override {
+		if (!traits_type::eq_int_type(c, traits_type::eof())) {
+			target_.push_back(traits_type::to_char_type(c));
+		}
+		return traits_type::not_eof(c);
+	}
+
+	std::streamsize xsputn(const char* s, std::streamsize count) override {
+		target_.append(s, static_cast<size_t>(count));
+		return count;
+	}
+
+private:
+	std::string& target_;
+};
+
+}
+
+void JSON_Reader::ReadRequests(std::istream& input, TransportCatalogue& catalogue, RequestHandler& handler) {
+	ReadRequests(view::Input::FromStream(input), catalogue, handler);
+}
+
+void JSON_Reader::ReadRequests(view::Input input, TransportCatalogue& catalogue, RequestHandler& handler) {
+	const view::Document doc = view::Load(std::move(input));
+	const view::Node& doc_root = doc.GetRoot();
 
 	if (!doc_root.IsDict()) {
 		throw ParsingError("Error");
 	}
 
-	auto requests_map = doc_root.AsDict();
-	ReadPropRouterRequests(requests_map.at("routing_settings"), router);
+	const auto& requests_map = doc_root.AsDict();
+	ReadBaseDocument(requests_map, catalogue);
+	ReadStatRequests(requests_map.at("stat_requests"), catalogue, handler);
+	// Разделы настроек ссылаются на документ, который сейчас будет освобождён
+	ResetSubsystems(nullptr);
+}
+
+void JSON_Reader::ReadStreamRequests(std::istream& input, TransportCatalogue& catalogue, RequestHandler& handler) {
+	using namespace std::literals;
+	// Документ с базой хранится до конца потока: на его разделы настроек ссылаются рендерер и маршрутизатор.
+	// Он может занимать несколько строк и читается до закрывающей скобки, остаток его последней строки пропускается
+	const view::Document base_doc = view::Load(view::Input::FromStreamValue(input));
+	if (!base_doc.GetRoot().IsDict()) {
+		throw ParsingError("Base document is expected"s);
+	}
+	input.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+	// Память ответа освобождается после вывода каждой строки, поэтому расход памяти не растёт с длиной потока
+	std::pmr::monotonic_buffer_resource arena;
+	// При любом выходе, в том числе по исключению, ответы снова строятся в памяти по умолчанию,
+	// а подсистемы забывают разделы настроек документа с базой, который будет освобождён
+	struct StreamScope {
+		JSON_Reader& reader;
+		~StreamScope() {
+			reader.response_resource_ = std::pmr::get_default_resource();
+			reader.ResetSubsystems(nullptr);
+		}
+	} scope{ *this };
+	ReadBaseDocument(base_doc.GetRoot().AsDict(), catalogue);
+	response_resource_ = &arena;
+
+	std::string line;
+	while (std::getline(input, line)) {
+		if (line.find_first_not_of(" \t\r"sv) == std::string::npos) {
+			continue;
+		}
+		{
+			// Ответ может ссылаться на строки запроса, поэтому выводится, пока документ запроса жив
+			std::optional<view::Document> request_doc;
+			std::optional<int> request_id;
+			Node response;
+			try {
+				request_doc.emplace(view::Load(view::Input::FromString(line), 1));
+				const view::Dict& request = request_doc->GetRoot().AsDict();
+				if (const view::Node* id = request.Find("id"); id && id->IsInt()) {
+					request_id = id->AsInt();
+				}
+				if (auto stat_response = ReadStatRequest(request, catalogue, handler)) {
+					response = std::move(*stat_response);
+				}
+				else {
+					response = PrintStreamErrorResult(request_id, "unknown request type"s);
+				}
+			}
+			catch (const std::exception& error) {
+				response = PrintStreamErrorResult(request_id, error.what());
+			}
+			Print(Document{ std::move(response) }, std::cout, PrintMode::COMPACT);
+			std::cout << '\n';
+			std::cout.flush();
+		}
+		arena.release();
+	}
+}
+
+Node JSON_Reader::PrintStreamErrorResult(std::optional<int> request_id, std::string error_message) {
+	return Builder{ response_resource_ }
+				.StartDict()
+					.Key("request_id").Value(request_id ? Node::Value{ *request_id } : Node::Value{ nullptr })
+					.Key("error_message").Value(std::move(error_message))
+				.EndDict()
+			.Build();
+}
+
+void JSON_Reader::ReadBaseDocument(const view::Dict& requests_map, TransportCatalogue& catalogue) {
+	ResetSubsystems(&requests_map);
 	ReadBaseRequests(requests_map.at("base_requests"), catalogue);
-	ReadPropMapRequests(requests_map.at("render_settings"), map_renderer);	
-	ReadStatRequests(requests_map.at("stat_requests"), handler, map_renderer, router);
 }
 
-void JSON_Reader::ReadPropRouterRequests(Node& root_node, TransportRouter& router) {
-	const auto& node_map = root_node.AsDict();
-	router.SetBusVelocity(node_map.at("bus_velocity").AsDouble())
-			.SetBusWaitTime(node_map.at("bus_wait_time").AsInt());
+void JSON_Reader::ResetSubsystems(const view::Dict* requests_map) {
+	map_renderer_.reset();
+	if (router_ && router_->GetRideCount() != 0) {
+		router_stats_ = RouterStats{ router_->GetRideCount(), router_->GetRideEdgeCount() };
+	}
+	router_.reset();
+	transfer_index_.reset();
+	name_search_indexes_.reset();
+	render_settings_ = requests_map ? requests_map->Find("render_settings") : nullptr;
+	routing_settings_ = requests_map ? requests_map->Find("routing_settings") : nullptr;
 }
 
-void JSON_Reader::ReadBaseRequests(Node& root_node, TransportCatalogue& catalogue) {
-	const auto& node_array = root_node.AsArray();
-	ReadStopRequests(node_array, catalogue);
-	ReadStopDistanceRequests(node_array, catalogue);
-	ReadBusRequests(node_array, catalogue);
+MapRenderer& JSON_Reader::GetMapRenderer(RequestHandler& handler) {
+	using namespace std::literals;
+	if (!map_renderer_) {
+		if (!render_settings_) {
+			throw std::out_of_range("Key 'render_settings' not found"s);
+		}
+		// Если настройки не прочитаны, рендерер не остаётся наполовину настроенным для следующих запросов потока
+		try {
+			ReadPropMapRequests(*render_settings_, map_renderer_.emplace(handler));
+		}
+		catch (...) {
+			map_renderer_.reset();
+			throw;
+		}
+	}
+	return *map_renderer_;
 }
 
-void JSON_Reader::ReadStopRequests(const Array& node_array, TransportCatalogue& catalogue) {
-	for (const auto& node : node_array) {
-		const auto& node_info = node.AsDict();
-		if (node_info.at("type") == "Stop") {
-			catalogue.AddStop(node_info.at("name").AsString(),
-				node_info.at("latitude").AsDouble(),
-				node_info.at("longitude").AsDouble());
+TransportRouter& JSON_Reader::GetRouter(TransportCatalogue& catalogue) {
+	using namespace std::literals;
+	if (!router_) {
+		if (!routing_settings_) {
+			throw std::out_of_range("Key 'routing_settings' not found"s);
+		}
+		try {
+			ReadPropRouterRequests(*routing_settings_, router_.emplace(catalogue));
+		}
+		catch (...) {
+			router_.reset();
+			throw;
 		}
 	}
+	return *router_;
 }
 
-void JSON_Reader::ReadStopDistanceRequests(const Array& node_array, TransportCatalogue& catalogue) {
-	for (const auto& node : node_array) {
-		const auto& node_info = node.AsDict();
-		if (node_info.at("type") == "Stop") {
-			for (const auto& stop_distance : node_info.at("road_distances").AsDict()) {
-				Stop* stop = catalogue.GetStop(node_info.at("name").AsString());
-				Stop* other_stop = catalogue.GetStop(stop_distance.first);
-				catalogue.AddDistanceBetweenStops(stop, other_stop, stop_distance.second.AsInt());
-			}
+const TransferIndex& JSON_Reader::GetTransferIndex(const TransportCatalogue& catalogue) {
+	if (!transfer_index_) {
+		transfer_index_.emplace(catalogue);
+	}
+	return *transfer_index_;
+}
+
+const JSON_Reader::NameSearchIndexes& JSON_Reader::GetNameSearchIndexes(const TransportCatalogue& catalogue) {
+	if (!name_search_indexes_) {
+		const CatalogueLayout& layout = catalogue.GetLayout();
+		std::vector<std::string_view> stop_names;
+		stop_names.reserve(layout.GetStopCount());
+		for (uint32_t stop_id = 0; stop_id < layout.GetStopCount(); ++stop_id) {
+			stop_names.push_back(layout.GetStopName(stop_id));
+		}
+		std::vector<std::string_view> bus_names;
+		bus_names.reserve(layout.GetBusCount());
+		for (uint32_t bus_id = 0; bus_id < layout.GetBusCount(); ++bus_id) {
+			bus_names.push_back(layout.GetBusName(bus_id));
 		}
+		name_search_indexes_.emplace(NameSearchIndexes{ NameSearchIndex(std::move(stop_names)), NameSearchIndex(std::move(bus_names)) });
 	}
+	return *name_search_indexes_;
+}
+
+void JSON_Reader::ReadPropRouterRequests(const view::Node& root_node, TransportRouter& router) {
+	const auto& node_map = root_node.AsDict();
+	router.SetBusVelocity(node_map.at("bus_velocity").AsDouble())
+			.SetBusWaitTime(node_map.at("bus_wait_time").AsInt());
 }
 
-void JSON_Reader::ReadBusRequests(const Array& node_array, TransportCatalogue& catalogue) {
-	for (const auto& node : node_array) {
+void JSON_Reader::ReadBaseRequests(const view::Node& root_node, TransportCatalogue& catalogue) {
+	PendingBaseRequests pending;
+	for (const auto& node : root_node.AsArray()) {
 		const auto& node_info = node.AsDict();
-		if (node_info.at("type") == "Bus") {
-			std::vector<Stop*> stops;
-			for (const auto& stop_name : node_info.at("stops").AsArray()) {
-				stops.emplace_back(catalogue.GetStop(stop_name.AsString()));
+		const std::string_view type = node_info.at("type").AsString();
+		if (type == "Stop") {
+			Stop* stop = catalogue.AddStop(node_info.at("name").AsString(),
+				node_info.at("latitude").AsDouble(),
+				node_info.at("longitude").AsDouble());
+			for (const auto& [other_stop, distance] : node_info.at("road_distances").AsDict()) {
+				pending.distances.push_back({ stop, other_stop, distance.AsInt() });
 			}
-			if (node_info.at("is_roundtrip").AsBool() == false) {
-				stops.insert(stops.end(), stops.rbegin() + 1, stops.rend());
+		}
+		else if (type == "Bus") {
+			const size_t stops_begin = pending.bus_stop_names.size();
+			for (const auto& stop_name : node_info.at("stops").AsArray()) {
+				pending.bus_stop_names.push_back(stop_name.AsString());
 			}
-			catalogue.AddBus(node_info.at("name").AsString(), stops, node_info.at("is_roundtrip").AsBool());
+			pending.buses.push_back({ node_info.at("name").AsString(), stops_begin, pending.bus_stop_names.size(),
+				node_info.at("is_roundtrip").AsBool() });
 		}
 	}
+	ResolvePendingRequests(pending, catalogue);
+	catalogue.Finalize();
 }
 
-void JSON_Reader::ReadStatRequests(Node& root_node, RequestHandler& handler, MapRenderer& map_renderer, TransportRouter& router) {
-	std::ostringstream output;
-	Array requests;
-	const auto& node_array = root_node.AsArray();
-	for (const auto& node : node_array) {
-		const auto& node_info = node.AsDict();
-		if (node_info.at("type") == "Bus") {
-			std::optional<statistics::BusInfo> bus_info = handler.GetBusInfo(node_info.at("name").AsString());
-			requests.push_back(PrintBusStatRequestsResult(node_info.at("id").AsInt(), bus_info));
+void JSON_Reader::ResolvePendingRequests(const PendingBaseRequests& pending, TransportCatalogue& catalogue) const {
+	using namespace std::literals;
+	auto resolve = [&catalogue](std::string_view stop_name) {
+		Stop* stop = catalogue.GetStop(stop_name);
+		if (!stop) {
+			throw std::invalid_argument("Unknown stop "s + std::string(stop_name));
 		}
-		else if (node_info.at("type") == "Stop") {
-			std::optional<statistics::StopInfo> stop_info = handler.GetStopInfo(node_info.at("name").AsString());
-			requests.push_back(PrintStopStatRequestsResult(node_info.at("id").AsInt(), stop_info));
+		return stop;
+	};
+
+	for (const auto& [from, to, distance] : pending.distances) {
+		catalogue.AddDistanceBetweenStops(from, resolve(to), distance);
+	}
+
+	std::vector<Stop*> stops;
+	for (const auto& bus : pending.buses) {
+		stops.clear();
+		for (size_t i = bus.stops_begin; i != bus.stops_end; ++i) {
+			stops.push_back(resolve(pending.bus_stop_names[i]));
 		}
-		else if (node_info.at("type") == "Map") {
-			map_renderer.DrawMap(output);
-			requests.push_back(PrintMapStatRequestsResult(node_info.at("id").AsInt(), output));
+		if (!bus.is_roundtrip) {
+			stops.insert(stops.end(), stops.rbegin() + 1, stops.rend());
 		}
-		else if (node_info.at("type") == "Route") {
-			std::optional<RouteAndEdgesInfo> route_info = router.GetRoute(node_info.at("from").AsString(), node_info.at("to").AsString());
-			requests.push_back(PrintRouteStatRequestsResult(node_info.at("id").AsInt(), route_info));
+		catalogue.AddBus(bus.name, stops, bus.is_roundtrip);
+	}
+}
+
+void JSON_Reader::ReadStatRequests(const view::Node& root_node, TransportCatalogue& catalogue, RequestHandler& handler) {
+	std::pmr::monotonic_buffer_resource arena;
+	response_resource_ = &arena;
+	Array requests(&arena);
+	for (const auto& node : root_node.AsArray()) {
+		if (auto response = ReadStatRequest(node.AsDict(), catalogue, handler)) {
+			requests.push_back(std::move(*response));
 		}
 	}
-	Document doc{ requests };
-	Print(doc, std::cout);
+	Document doc{ std::move(requests) };
+	Print(doc, std::cout, print_mode_);
+	response_resource_ = std::pmr::get_default_resource();
 }
 
-svg::Color JSON_Reader::GetColorFromNode(json::Node node) const {
+std::optional<Node> JSON_Reader::ReadStatRequest(const view::Dict& node_info, TransportCatalogue& catalogue, RequestHandler& handler) {
+	const std::string_view type = node_info.at("type").AsString();
+	if (type == "Bus") {
+		std::optional<statistics::BusInfo> bus_info = handler.GetBusInfo(node_info.at("name").AsString());
+		return PrintBusStatRequestsResult(node_info.at("id").AsInt(), bus_info);
+	}
+	else if (type == "Stop") {
+		std::optional<statistics::StopInfo> stop_info = handler.GetStopInfo(node_info.at("name").AsString());
+		return PrintStopStatRequestsResult(node_info.at("id").AsInt(), stop_info);
+	}
+	else if (type == "Map") {
+		std::string map;
+		StringAppendBuffer map_buffer(map);
+		std::ostream map_output(&map_buffer);
+		GetMapRenderer(handler).DrawMap(map_output);
+		return PrintMapStatRequestsResult(node_info.at("id").AsInt(), std::move(map));
+	}
+	else if (type == "Route") {
+		std::optional<RouteAndEdgesInfo> route_info = GetRouter(catalogue).GetRoute(node_info.at("from").AsString(), node_info.at("to").AsString());
+		return PrintRouteStatRequestsResult(node_info.at("id").AsInt(), route_info);
+	}
+	else if (type == "Aggregate") {
+		return ReadAggregateRequest(node_info, handler);
+	}
+	else if (type == "BusSegment") {
+		return ReadBusSegmentRequest(node_info, handler);
+	}
+	else if (type == "CommonBuses") {
+		return PrintNamesStatRequestsResult(node_info.at("id").AsInt(), "buses",
+			GetTransferIndex(catalogue).GetCommonBuses(node_info.at("from").AsString(), node_info.at("to").AsString()));
+	}
+	else if (type == "StopSearch") {
+		return ReadStopSearchRequest(node_info, catalogue);
+	}
+	else if (type == "TransferStops") {
+		return PrintNamesStatRequestsResult(node_info.at("id").AsInt(), "stops",
+			GetTransferIndex(catalogue).GetTransferStops(node_info.at("from").AsString(), node_info.at("to").AsString()));
+	}
+	return std::nullopt;
+}
+
+Node JSON_Reader::ReadBusSegmentRequest(const view::Dict& node_info, RequestHandler& handler) {
+	using namespace std::literals;
+	const int request_id = node_info.at("id").AsInt();
+	// Время поездки зависит только от скорости автобуса, поэтому граф маршрутизатора для него не строится
+	if (!routing_settings_) {
+		return Builder{ response_resource_ }
+					.StartDict()
+						.Key("request_id").Value(request_id)
+						.Key("error_message").Value("routing settings not found"sv)
+					.EndDict()
+				.Build();
+	}
+	std::optional<statistics::BusSegmentInfo> segment_info = handler.GetBusSegmentInfo(node_info.at("name").AsString(),
+		node_info.at("from").AsString(), node_info.at("to").AsString());
+	const double ride_time = segment_info
+		? TransportRouter::ComputeRideTime(segment_info->distance, routing_settings_->AsDict().at("bus_velocity").AsDouble())
+		: 0.0;
+	return PrintBusSegmentStatRequestsResult(request_id, segment_info, ride_time);
+}
+
+Node JSON_Reader::ReadStopSearchRequest(const view::Dict& node_info, const TransportCatalogue& catalogue) {
+	using namespace std::literals;
+	const std::string_view query = node_info.at("query").AsString();
+	const view::Node* mode = node_info.Find("mode");
+	const view::Node* max_distance = node_info.Find("max_distance");
+	const view::Node* limit = node_info.Find("limit");
+	const size_t result_limit = limit ? static_cast<size_t>(std::max(limit->AsInt(), 0)) : 10;
+
+	const NameSearchIndexes& indexes = GetNameSearchIndexes(catalogue);
+	if (!mode || mode->AsString() == "prefix"sv) {
+		return PrintStopSearchStatRequestsResult(node_info.at("id").AsInt(),
+			indexes.stops.FindByPrefix(query, result_limit), indexes.buses.FindByPrefix(query, result_limit));
+	}
+	if (mode->AsString() == "fuzzy"sv) {
+		const int distance = max_distance ? max_distance->AsInt() : 1;
+		return PrintStopSearchStatRequestsResult(node_info.at("id").AsInt(),
+			indexes.stops.FindFuzzy(query, distance, result_limit), indexes.buses.FindFuzzy(query, distance, result_limit));
+	}
+	throw std::invalid_argument("Unknown search mode "s + std::string(mode->AsString()));
+}
+
+Node JSON_Reader::ReadAggregateRequest(const view::Dict& node_info, RequestHandler& handler) {
+	using namespace std::literals;
+	const std::string_view metric_name = node_info.at("metric").AsString();
+	RankingMetric metric;
+	if (metric_name == "route_length"sv) {
+		metric = RankingMetric::ROUTE_LENGTH;
+	}
+	else if (metric_name == "curvature"sv) {
+		metric = RankingMetric::CURVATURE;
+	}
+	else if (metric_name == "stop_count"sv) {
+		metric = RankingMetric::STOP_COUNT;
+	}
+	else if (metric_name == "unique_stop_count"sv) {
+		metric = RankingMetric::UNIQUE_STOP_COUNT;
+	}
+	else if (metric_name == "bus_count"sv) {
+		metric = RankingMetric::STOP_BUS_COUNT;
+	}
+	else {
+		throw std::invalid_argument("Unknown metric "s + std::string(metric_name));
+	}
+	const view::Node* limit = node_info.Find("limit");
+	const view::Node* min_value = node_info.Find("min");
+	const view::Node* max_value = node_info.Find("max");
+	return PrintAggregateStatRequestsResult(node_info.at("id").AsInt(), metric,
+		handler.GetLayout().GetTopRanked(metric,
+			limit ? static_cast<size_t>(std::max(limit->AsInt(), 0)) : 10,
+			min_value ? min_value->AsDouble() : -std::numeric_limits<double>::infinity(),
+			max_value ? max_value->AsDouble() : std::numeric_limits<double>::infinity()));
+}
+
+svg::Color JSON_Reader::GetColorFromNode(const view::Node& node) const {
 	if (node.IsArray()) {
 		if (node.AsArray().size() == 3) {
 			return svg::Rgb(node.AsArray()[0].AsInt(),
@@ -111,10 +394,10 @@ svg::Color JSON_Reader::GetColorFromNode(json::Node node) const {
 
 		}
 	}
-	return node.AsString();
+	return std::string{ node.AsString() };
 }
 
-void JSON_Reader::ReadPropMapRequests(Node& root_node, MapRenderer& map_renderer) {
+void JSON_Reader::ReadPropMapRequests(const view::Node& root_node, MapRenderer& map_renderer) {
 	const auto& node_map = root_node.AsDict();
 	const auto& bus_offset_node = node_map.at("bus_label_offset").AsArray();
 	const auto& stop_offset_node = node_map.at("stop_label_offset").AsArray();
@@ -143,18 +426,19 @@ void JSON_Reader::ReadPropMapRequests(Node& root_node, MapRenderer& map_renderer
 }
 
 Node JSON_Reader::PrintBusStatRequestsResult(int request_id, std::optional<statistics::BusInfo> bus_info) {
+	using namespace std::literals;
 	Node bus_node;
 
 	if (!bus_info) {
-		bus_node = Builder{}
+		bus_node = Builder{ response_resource_ }
 						.StartDict()
 							.Key("request_id").Value(request_id)
-							.Key("error_message").Value("not found")
+							.Key("error_message").Value("not found"sv)
 						.EndDict()
 					.Build();
 	}
 	else {
-		bus_node = Builder{}
+		bus_node = Builder{ response_resource_ }
 						.StartDict()
 							.Key("request_id").Value(request_id)
 							.Key("curvature").Value(bus_info.value().curvature)
@@ -169,25 +453,27 @@ Node JSON_Reader::PrintBusStatRequestsResult(int request_id, std::optional<stati
 }
 
 Node JSON_Reader::PrintStopStatRequestsResult(int request_id, std::optional<statistics::StopInfo> stop_info) {
+	using namespace std::literals;
 	Node stop_node;
 
 	if (!stop_info) {
-		stop_node = Builder{}
+		stop_node = Builder{ response_resource_ }
 						.StartDict()
 							.Key("request_id").Value(request_id)
-							.Key("error_message").Value("not found")
+							.Key("error_message").Value("not found"sv)
 						.EndDict()
 					.Build();
 	}
 	else {
-		Array buses_array;
-		for (const auto& bus : stop_info.value().buses) {
-			buses_array.push_back(std::string{ bus });
+		Array buses_array(response_resource_);
+		buses_array.reserve(stop_info.value().buses.size());
+		for (std::string_view bus : stop_info.value().buses) {
+			buses_array.push_back(bus);
 		}
-		stop_node = Builder{}
+		stop_node = Builder{ response_resource_ }
 						.StartDict()
 							.Key("request_id").Value(request_id)
-							.Key("buses").Value(buses_array)
+							.Key("buses").Value(std::move(buses_array))
 						.EndDict()
 					.Build();
 	}
@@ -195,52 +481,53 @@ Node JSON_Reader::PrintStopStatRequestsResult(int request_id, std::optional<stat
 	return stop_node;
 }
 
-Node JSON_Reader::PrintMapStatRequestsResult(int request_id, std::ostringstream& output) {
-	Node svg_str = Builder{}
+Node JSON_Reader::PrintMapStatRequestsResult(int request_id, std::string map) {
+	Node svg_str = Builder{ response_resource_ }
 						.StartDict()
 							.Key("request_id").Value(request_id)
-							.Key("map").Value(output.str())
+							.Key("map").Value(std::move(map))
 						.EndDict()
 					.Build();
 	return svg_str;
 }
 
 Node JSON_Reader::PrintRouteStatRequestsResult(int request_id, std::optional<RouteAndEdgesInfo> route_info) {
+	using namespace std::literals;
 	Node route_node;
 
 	if (!route_info) {
-		route_node = Builder{}
+		route_node = Builder{ response_resource_ }
 						.StartDict()
 							.Key("request_id").Value(request_id)
-							.Key("error_message").Value("not found")
+							.Key("error_message").Value("not found"sv)
 						.EndDict()
 					.Build();
 	}
 	else {
-		Array items_array;
+		Array items_array(response_resource_);
 		for (const auto& item : route_info.value().edges) {				
-			Dict edges_info;
+			Dict edges_info(response_resource_);
 			if (std::holds_alternative<BusEdge>(item)) {
 				BusEdge bus_edge = std::get<BusEdge>(item);
 				edges_info["bus"] = bus_edge.bus_name;
 				edges_info["span_count"] = bus_edge.span_count;
 				edges_info["time"] = bus_edge.ride_time;
-				edges_info["type"] = "Bus";
+				edges_info["type"] = "Bus"sv;
 			}
 			else if (std::holds_alternative<WaitEdge>(item)) {
 				WaitEdge wait_edge = std::get<WaitEdge>(item);
 				edges_info["stop_name"] = wait_edge.stop_name;
 				edges_info["time"] = wait_edge.wait_time;
-				edges_info["type"] = "Wait";
+				edges_info["type"] = "Wait"sv;
 			}
-			items_array.push_back(edges_info);
+			items_array.push_back(std::move(edges_info));
 		}
 
-		route_node = Builder{}
+		route_node = Builder{ response_resource_ }
 						.StartDict()
 							.Key("request_id").Value(request_id)
 							.Key("total_time").Value(route_info.value().time)
-							.Key("items").Value(items_array)
+							.Key("items").Value(std::move(items_array))
 						.EndDict()
 					.Build();
 	}
@@ -248,4 +535,123 @@ Node JSON_Reader::PrintRouteStatRequestsResult(int request_id, std::optional<Rou
 	return route_node;
 }
 
+Node JSON_Reader::PrintBusSegmentStatRequestsResult(int request_id, std::optional<statistics::BusSegmentInfo> segment_info, double ride_time) {
+	using namespace std::literals;
+	Node segment_node;
+
+	if (!segment_info) {
+		segment_node = Builder{ response_resource_ }
+						.StartDict()
+							.Key("request_id").Value(request_id)
+							.Key("error_message").Value("not found"sv)
+						.EndDict()
+					.Build();
+	}
+	else {
+		segment_node = Builder{ response_resource_ }
+						.StartDict()
+							.Key("request_id").Value(request_id)
+							.Key("distance").Value(segment_info.value().distance)
+							.Key("span_count").Value(segment_info.value().span_count)
+							.Key("time").Value(ride_time)
+						.EndDict()
+					.Build();
+	}
+
+	return segment_node;
+}
+
+Node JSON_Reader::PrintNamesStatRequestsResult(int request_id, std::string key, std::optional<std::vector<std::string_view>> names) {
+	using namespace std::literals;
+	Node names_node;
+
+	if (!names) {
+		names_node = Builder{ response_resource_ }
+						.StartDict()
+							.Key("request_id").Value(request_id)
+							.Key("error_message").Value("not found"sv)
+						.EndDict()
+					.Build();
+	}
+	else {
+		Array names_array(response_resource_);
+		names_array.reserve(names.value().size());
+		for (const auto& name : names.value()) {
+			names_array.push_back(name);
+		}
+		names_node = Builder{ response_resource_ }
+						.StartDict()
+							.Key("request_id").Value(request_id)
+							.Key(std::move(key)).Value(std::move(names_array))
+						.EndDict()
+					.Build();
+	}
+
+	return names_node;
+}
+
+Node JSON_Reader::PrintStopSearchStatRequestsResult(int request_id, const std::vector<std::string_view>& stops, const std::vector<std::string_view>& buses) {
+	Array stops_array(response_resource_);
+	stops_array.reserve(stops.size());
+	for (std::string_view stop : stops) {
+		stops_array.push_back(stop);
+	}
+	Array buses_array(response_resource_);
+	buses_array.reserve(buses.size());
+	for (std::string_view bus : buses) {
+		buses_array.push_back(bus);
+	}
+	return Builder{ response_resource_ }
+				.StartDict()
+					.Key("request_id").Value(request_id)
+					.Key("stops").Value(std::move(stops_array))
+					.Key("buses").Value(std::move(buses_array))
+				.EndDict()
+			.Build();
+}
+
+Node JSON_Reader::PrintAggregateStatRequestsResult(int request_id, RankingMetric metric, const std::vector<RankedItem>& items) {
+	Array items_array(response_resource_);
+	items_array.reserve(items.size());
+	for (const RankedItem& item : items) {
+		Dict item_info(response_resource_);
+		item_info["name"] = item.name;
+		// Кроме извилистости, все показатели целые
+		if (metric == RankingMetric::CURVATURE) {
+			item_info["value"] = item.value;
+		}
+		else {
+			item_info["value"] = static_cast<int>(item.value);
+		}
+		items_array.push_back(std::move(item_info));
+	}
+	return Builder{ response_resource_ }
+				.StartDict()
+					.Key("request_id").Value(request_id)
+					.Key("items").Value(std::move(items_array))
+				.EndDict()
+			.Build();
+}
+
+void JSON_Reader::PrintStats(const TransportCatalogue& catalogue, std::ostream& output) const {
+	const StringPoolStats pool = catalogue.GetNamePoolStats();
+	Builder builder;
+	builder.StartDict()
+		.Key("name_pool").StartDict()
+			.Key("unique_strings").Value(static_cast<int>(pool.unique_strings))
+			.Key("intern_calls").Value(static_cast<int>(pool.intern_calls))
+			.Key("bytes_used").Value(static_cast<int>(pool.bytes_used))
+			.Key("bytes_reserved").Value(static_cast<int>(pool.bytes_reserved))
+			.Key("std_string_bytes").Value(static_cast<int>(pool.std_string_bytes))
+		.EndDict();
+	if (router_stats_) {
+		builder.Key("router").StartDict()
+			.Key("rides").Value(static_cast<int>(router_stats_->ride_count))
+			.Key("ride_edges").Value(static_cast<int>(router_stats_->ride_edge_count))
+		.EndDict();
+	}
+	Print(Document{ builder.EndDict().Build() }, output, PrintMode::COMPACT);
+	output << '\n';
+}
+
 }
\ No newline at end of file
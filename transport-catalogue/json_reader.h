@@ -1,12 +1,17 @@
 #pragma once
 #include "json.h"
 #include "json_builder.h"
+#include "json_view.h"
 #include "map_renderer.h"
 #include "request_handler.h"
 #include "transport_catalogue.h"
+#include <limits>
+#include <memory_resource>
 #include <sstream>
 #include <unordered_map>
 #include "transport_router.h"
+#include "transfer_index.h"
+#include "name_search_index.h"
 
 namespace json_reader {
 
@@ -16,19 +21,100 @@ using namespace transport_catalogue;
 class JSON_Reader
 {
 public:
-	void ReadRequests(std::istream& input, TransportCatalogue& catalogue, RequestHandler& handler, MapRenderer& map_renderer, TransportRouter& router);
-	void ReadPropRouterRequests(Node& root_node, TransportRouter& router);
-	void ReadBaseRequests(Node& root_node, TransportCatalogue& catalogue);
-	void ReadStopRequests(const Array& node_array, TransportCatalogue& catalogue);
-	void ReadStopDistanceRequests(const Array& node_array, TransportCatalogue& catalogue);
-	void ReadBusRequests(const Array& node_array, TransportCatalogue& catalogue);
-	void ReadStatRequests(Node& root_node, RequestHandler& handler, MapRenderer& map_renderer, TransportRouter& router);
-	void ReadPropMapRequests(Node& root_node, MapRenderer& map_renderer);
+	explicit JSON_Reader(PrintMode print_mode = PrintMode::PRETTY)
+		: print_mode_(print_mode) {
+	}
+
+	void ReadRequests(std::istream& input, TransportCatalogue& catalogue, RequestHandler& handler);
+	void ReadRequests(view::Input input, TransportCatalogue& catalogue, RequestHandler& handler);
+	// Потоковый режим (NDJSON): сначала документ с базой и настройками без stat_requests, он может занимать несколько строк;
+	// каждая следующая строка — один запрос статистики. Ответ на запрос выводится одной строкой сразу после его обработки.
+	// На каждую непустую строку выводится ровно один ответ: если запрос не разобран или его тип неизвестен,
+	// это {"request_id": id или null, "error_message": описание ошибки}, и поток продолжается.
+	void ReadStreamRequests(std::istream& input, TransportCatalogue& catalogue, RequestHandler& handler);
+	void ReadBaseDocument(const view::Dict& requests_map, TransportCatalogue& catalogue);
+	void ReadPropRouterRequests(const view::Node& root_node, TransportRouter& router);
+	void ReadBaseRequests(const view::Node& root_node, TransportCatalogue& catalogue);
+	void ReadStatRequests(const view::Node& root_node, TransportCatalogue& catalogue, RequestHandler& handler);
+	std::optional<Node> ReadStatRequest(const view::Dict& node_info, TransportCatalogue& catalogue, RequestHandler& handler);
+	void ReadPropMapRequests(const view::Node& root_node, MapRenderer& map_renderer);
 	Node PrintBusStatRequestsResult(int request_id, std::optional<statistics::BusInfo> bus_info);
 	Node PrintStopStatRequestsResult(int request_id, std::optional<statistics::StopInfo> stop_info);
-	Node PrintMapStatRequestsResult(int request_id, std::ostringstream& output);
+	Node PrintMapStatRequestsResult(int request_id, std::string map);
 	Node PrintRouteStatRequestsResult(int request_id, std::optional<RouteAndEdgesInfo> route_info);
-	svg::Color GetColorFromNode(json::Node node) const;
+	Node PrintBusSegmentStatRequestsResult(int request_id, std::optional<statistics::BusSegmentInfo> segment_info, double ride_time);
+	// Ответ со списком названий под ключом key: маршрутов для CommonBuses, остановок для TransferStops
+	Node PrintNamesStatRequestsResult(int request_id, std::string key, std::optional<std::vector<std::string_view>> names);
+	Node PrintStopSearchStatRequestsResult(int request_id, const std::vector<std::string_view>& stops, const std::vector<std::string_view>& buses);
+	Node PrintStreamErrorResult(std::optional<int> request_id, std::string error_message);
+	Node PrintAggregateStatRequestsResult(int request_id, RankingMetric metric, const std::vector<RankedItem>& items);
+	svg::Color GetColorFromNode(const view::Node& node) const;
+	// Сводка о расходе памяти одной строкой JSON: пул имён справочника и, если маршруты строились,
+	// число поездок без пересадок и рёбер поездок в графе последнего маршрутизатора
+	void PrintStats(const TransportCatalogue& catalogue, std::ostream& output) const;
+
+private:
+	// Расстояния и маршруты ссылаются на остановки по имени, а остановка может быть описана позже,
+	// поэтому такие ссылки копятся за проход по базовым запросам и разрешаются в конце
+	struct PendingDistance {
+		Stop* from;
+		std::string_view to;
+		int distance;
+	};
+
+	struct PendingBus {
+		std::string_view name;
+		size_t stops_begin;
+		size_t stops_end;
+		bool is_roundtrip;
+	};
+
+	struct PendingBaseRequests {
+		std::vector<PendingDistance> distances;
+		std::vector<PendingBus> buses;
+		// Имена остановок всех маршрутов подряд; маршрут занимает отрезок [stops_begin, stops_end)
+		std::vector<std::string_view> bus_stop_names;
+	};
+
+	void ResolvePendingRequests(const PendingBaseRequests& pending, TransportCatalogue& catalogue) const;
+
+	// Рендерер карты и маршрутизатор создаются при первом запросе, которому они нужны:
+	// в пакете без запросов Map и Route настройки отрисовки и маршрутизации не разбираются, а граф не строится
+	void ResetSubsystems(const view::Dict* requests_map);
+	MapRenderer& GetMapRenderer(RequestHandler& handler);
+	TransportRouter& GetRouter(TransportCatalogue& catalogue);
+	const TransferIndex& GetTransferIndex(const TransportCatalogue& catalogue);
+
+	struct NameSearchIndexes {
+		NameSearchIndex stops;
+		NameSearchIndex buses;
+	};
+	const NameSearchIndexes& GetNameSearchIndexes(const TransportCatalogue& catalogue);
+	// Запрос BusSegment: время поездки считается по скорости из routing_settings
+	Node ReadBusSegmentRequest(const view::Dict& node_info, RequestHandler& handler);
+	// Запрос StopSearch: "query", необязательные "mode" ("prefix" или "fuzzy"), "max_distance" и "limit"
+	Node ReadStopSearchRequest(const view::Dict& node_info, const TransportCatalogue& catalogue);
+	// Запрос Aggregate: "metric" ("route_length", "curvature", "stop_count", "unique_stop_count" или "bus_count"),
+	// необязательные "limit", "min" и "max"
+	Node ReadAggregateRequest(const view::Dict& node_info, RequestHandler& handler);
+
+	// Разделы настроек текущего входного документа
+	const view::Node* render_settings_ = nullptr;
+	const view::Node* routing_settings_ = nullptr;
+	std::optional<MapRenderer> map_renderer_;
+	std::optional<TransportRouter> router_;
+	std::optional<TransferIndex> transfer_index_;
+	std::optional<NameSearchIndexes> name_search_indexes_;
+	// Размер графа маршрутизатора, сохранённый при его сбросе для сводки PrintStats
+	struct RouterStats {
+		size_t ride_count;
+		size_t ride_edge_count;
+	};
+	std::optional<RouterStats> router_stats_;
+
+	PrintMode print_mode_;
+	// Ресурс памяти, в котором строятся ответы текущего пакета запросов
+	std::pmr::memory_resource* response_resource_ = std::pmr::get_default_resource();
 
 };
 
@@ -0,0 +1,827 @@
+#include "json_view.h"
+#include "bits.h"
+#include "thread_pool.h"
+
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <optional>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define JSON_VIEW_USE_MMAP 1
+#endif
+
+namespace json::view {
+
+namespace {
+using namespace std::literals;
+
+// Этап 1: поиск структурных символов.
+// Текст обрабатывается блоками по 64 байта; для каждого блока строятся битовые маски классов символов,
+// по ним вычисляются границы строк и позиции структурных символов, кавычек и начал скаляров.
+
+struct BlockMasks {
+    uint64_t quote = 0;
+    uint64_t backslash = 0;
+    uint64_t op = 0;
+    uint64_t whitespace = 0;
+    uint64_t newline = 0;
+};
+
+constexpr size_t BLOCK_SIZE = 64;
+
+#if defined(__AVX2__)
+
+uint64_t EqualMask(__m256i lo, __m256i hi, char c) {
+    const __m256i pattern = _mm256_set1_epi8(c);
+    const uint64_t lo_mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, pattern)));
+    const uint64_t hi_mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, pattern)));
+    return lo_mask | (hi_mask << 32);
+}
+
+uint64_t ControlSpaceMask(__m256i lo, __m256i hi) {
+    auto half = [](__m256i chunk) -> uint64_t {
+        const __m256i is_control_space = _mm256_and_si256(_mm256_cmpgt_epi8(chunk, _mm256_set1_epi8(8)),
+                                                          _mm256_cmpgt_epi8(_mm256_set1_epi8(14), chunk));
+        return static_cast<uint32_t>(_mm256_movemask_epi8(is_control_space));
+    };
+    return half(lo) | (half(hi) << 32);
+}
+
+BlockMasks ClassifyBlock(const char* block) {
+    const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    // '[' и ']' отличаются от '{' и '}' только битом 0x20
+    const __m256i lo_folded = _mm256_or_si256(lo, _mm256_set1_epi8(0x20));
+    const __m256i hi_folded = _mm256_or_si256(hi, _mm256_set1_epi8(0x20));
+
+    BlockMasks masks;
+    masks.quote = EqualMask(lo, hi, '"');
+    masks.backslash = EqualMask(lo, hi, '\\');
+    masks.op = EqualMask(lo_folded, hi_folded, '{') | EqualMask(lo_folded, hi_folded, '}')
+        | EqualMask(lo, hi, ':') | EqualMask(lo, hi, ',');
+    masks.whitespace = EqualMask(lo, hi, ' ') | ControlSpaceMask(lo, hi);
+    masks.newline = EqualMask(lo, hi, '\n') | EqualMask(lo, hi, '\r');
+    return masks;
+}
+
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+template <typename Predicate>
+uint64_t BlockMask(const __m128i (&chunks)[4], Predicate predicate) {
+    uint64_t mask = 0;
+    for (int i = 0; i < 4; ++i) {
+        mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(predicate(chunks[i])))) << (16 * i);
+    }
+    return mask;
+}
+
+BlockMasks ClassifyBlock(const char* block) {
+    const __m128i chunks[4] = {
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(block)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 32)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 48)),
+    };
+    auto equal = [](char c) {
+        return [pattern = _mm_set1_epi8(c)](__m128i chunk) {
+            return _mm_cmpeq_epi8(chunk, pattern);
+        };
+    };
+
+    BlockMasks masks;
+    masks.quote = BlockMask(chunks, equal('"'));
+    masks.backslash = BlockMask(chunks, equal('\\'));
+    // '[' и ']' отличаются от '{' и '}' только битом 0x20
+    masks.op = BlockMask(chunks, [](__m128i chunk) {
+        const __m128i folded = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+        return _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(folded, _mm_set1_epi8('}'))),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(','))));
+    });
+    masks.whitespace = BlockMask(chunks, [](__m128i chunk) {
+        const __m128i is_control_space = _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8(8)),
+                                                       _mm_cmplt_epi8(chunk, _mm_set1_epi8(14)));
+        return _mm_or_si128(is_control_space, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')));
+    });
+    masks.newline = BlockMask(chunks, [](__m128i chunk) {
+        return _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')));
+    });
+    return masks;
+}
+
+#else
+
+BlockMasks ClassifyBlock(const char* block) {
+    BlockMasks masks;
+    for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+        const uint64_t bit = uint64_t{1} << i;
+        switch (block[i]) {
+            case '"':
+                masks.quote |= bit;
+                break;
+            case '\\':
+                masks.backslash |= bit;
+                break;
+            case '{':
+            case '}':
+            case '[':
+            case ']':
+            case ':':
+            case ',':
+                masks.op |= bit;
+                break;
+            case '\n':
+            case '\r':
+                masks.newline |= bit;
+                masks.whitespace |= bit;
+                break;
+            case ' ':
+            case '\t':
+            case '\v':
+            case '\f':
+                masks.whitespace |= bit;
+                break;
+            default:
+                break;
+        }
+    }
+    return masks;
+}
+
+#endif
+
+// Побитовый префиксный XOR: бит i результата равен чётности числа единиц в битах 0..i
+uint64_t PrefixXor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+template <typename Offset>
+class StructuralIndexer {
+public:
+    explicit StructuralIndexer(std::string_view text)
+        : text_(text) {
+    }
+
+    // Возвращает позиции всех структурных символов, кавычек вне экранирования и начал скаляров
+    std::vector<Offset> Build() {
+        std::vector<Offset> positions;
+        positions.reserve(text_.size() / 8);
+
+        size_t block_begin = 0;
+        for (; block_begin + BLOCK_SIZE <= text_.size(); block_begin += BLOCK_SIZE) {
+            ProcessBlock(text_.data() + block_begin, block_begin, positions);
+        }
+        if (block_begin < text_.size()) {
+            char tail[BLOCK_SIZE];
+            std::fill(std::begin(tail), std::end(tail), ' ');
+            std::copy(text_.begin() + block_begin, text_.end(), tail);
+            ProcessBlock(tail, block_begin, positions);
+        }
+        if (in_string_) {
+            throw ParsingError("String parsing error"s);
+        }
+        return positions;
+    }
+
+private:
+    void ProcessBlock(const char* block, size_t block_begin, std::vector<Offset>& positions) {
+        const BlockMasks masks = ClassifyBlock(block);
+
+        const uint64_t escaped = FindEscaped(masks.backslash);
+        const uint64_t quotes = masks.quote & ~escaped;
+        // Маска строк включает открывающую кавычку и не включает закрывающую
+        const uint64_t in_string = PrefixXor(quotes) ^ (in_string_ ? ~uint64_t{0} : 0);
+        in_string_ = (in_string >> 63) != 0;
+
+        if (masks.newline & in_string) {
+            throw ParsingError("Unexpected end of line"s);
+        }
+
+        const uint64_t scalar = ~(masks.op | masks.whitespace | quotes | in_string);
+        const uint64_t scalar_starts = scalar & ~((scalar << 1) | (prev_scalar_ ? 1 : 0));
+        prev_scalar_ = (scalar >> 63) != 0;
+
+        for (uint64_t structurals = (masks.op & ~in_string) | quotes | scalar_starts; structurals != 0;
+             structurals &= structurals - 1) {
+            positions.push_back(static_cast<Offset>(block_begin + bits::CountTrailingZeros(structurals)));
+        }
+    }
+
+    // Отмечает символы, перед которыми стоит неэкранированная обратная косая черта.
+    // Такие символы редки, поэтому они обходятся по одному.
+    uint64_t FindEscaped(uint64_t backslash) {
+        uint64_t escaped = escape_next_ ? 1 : 0;
+        escape_next_ = false;
+        for (; backslash != 0; backslash &= backslash - 1) {
+            const uint64_t bit = backslash & (~backslash + 1);
+            if (escaped & bit) {
+                continue;
+            }
+            if (bit == uint64_t{1} << 63) {
+                escape_next_ = true;
+            } else {
+                escaped |= bit << 1;
+            }
+        }
+        return escaped;
+    }
+
+    std::string_view text_;
+    bool in_string_ = false;
+    bool escape_next_ = false;
+    bool prev_scalar_ = false;
+};
+
+// Этап 2: построение узлов по индексу структурных символов
+template <typename Offset>
+class Parser {
+public:
+    // Параллельно разбираются только массивы в корне документа или в его словаре, например base_requests.
+    // Меньшие массивы выгоднее разбирать в одном потоке.
+    static constexpr size_t MAX_PARALLEL_DEPTH = 1;
+    static constexpr size_t PARALLEL_MIN_POSITIONS = 1 << 16;
+    static constexpr size_t MIN_CHUNK_ELEMENTS = 256;
+    static constexpr size_t CHUNKS_PER_THREAD = 4;
+
+    // Каждый парсер раскодирует строки в собственное хранилище, поэтому парсеры частей массива
+    // могут работать в разных потоках. Если задан pool, большие массивы верхних уровней разбираются параллельно.
+    Parser(std::string_view text, const std::vector<Offset>& positions, std::deque<std::deque<std::string>>& string_storages,
+           parallel::ThreadPool* pool)
+        : text_(text)
+        , positions_(positions)
+        , string_storages_(string_storages)
+        , unescaped_strings_(string_storages.emplace_back())
+        , pool_(pool) {
+    }
+
+    Node ParseDocument() {
+        return ParseNode();
+    }
+
+private:
+    static bool IsDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    static bool IsAlpha(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    // Скаляр должен заканчиваться пробельным или структурным символом
+    static bool IsScalarEnd(char c) {
+        switch (c) {
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+            case '\v':
+            case '\f':
+            case ',':
+            case ':':
+            case '[':
+            case ']':
+            case '{':
+            case '}':
+            case '"':
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    size_t PeekPosition() const {
+        if (next_ == positions_.size()) {
+            throw ParsingError("Unexpected EOF"s);
+        }
+        return positions_[next_];
+    }
+
+    char Peek() const {
+        return text_[PeekPosition()];
+    }
+
+    size_t NextPosition() {
+        const size_t position = PeekPosition();
+        ++next_;
+        return position;
+    }
+
+    Node ParseNode() {
+        const size_t position = NextPosition();
+        switch (text_[position]) {
+            case '[':
+                return ParseArray();
+            case '{':
+                return ParseDict();
+            case '"':
+                return ParseString(position);
+            case 't':
+                [[fallthrough]];
+            case 'f':
+                return ParseBool(position);
+            case 'n':
+                return ParseNull(position);
+            default:
+                return ParseNumber(position);
+        }
+    }
+
+    Node ParseArray() {
+        Array result;
+        if (Peek() == ']') {
+            ++next_;
+            return result;
+        }
+        if (pool_ && depth_ <= MAX_PARALLEL_DEPTH && positions_.size() - next_ >= PARALLEL_MIN_POSITIONS) {
+            if (auto parallel_result = ParseArrayInParallel()) {
+                return std::move(*parallel_result);
+            }
+        }
+        ++depth_;
+        while (true) {
+            result.push_back(ParseNode());
+            const char c = text_[NextPosition()];
+            if (c == ']') {
+                break;
+            }
+            if (c != ',') {
+                throw ParsingError("Array parsing error"s);
+            }
+        }
+        --depth_;
+        return result;
+    }
+
+    // Делит массив на части по границам элементов и разбирает части в пуле потоков.
+    // Элементы записываются в результат по своим индексам, так что порядок совпадает с последовательным разбором.
+    // Возвращает nullopt, если массив слишком мал для разделения или его границы не удалось найти.
+    std::optional<Array> ParseArrayInParallel() {
+        std::vector<size_t> element_starts;
+        const auto close_index = FindElementStarts(element_starts);
+        if (!close_index) {
+            return std::nullopt;
+        }
+        const size_t element_count = element_starts.size();
+        const size_t chunk_count = std::min(element_count / MIN_CHUNK_ELEMENTS, pool_->GetThreadCount() * CHUNKS_PER_THREAD);
+        if (chunk_count <= 1) {
+            return std::nullopt;
+        }
+        if (text_[positions_[*close_index]] != ']') {
+            throw ParsingError("Array parsing error"s);
+        }
+
+        std::vector<Parser> chunk_parsers;
+        chunk_parsers.reserve(chunk_count);
+        for (size_t i = 0; i < chunk_count; ++i) {
+            chunk_parsers.emplace_back(text_, positions_, string_storages_, nullptr);
+        }
+
+        Array result(element_count);
+        pool_->ParallelFor(chunk_count, [&](size_t chunk) {
+            Parser& parser = chunk_parsers[chunk];
+            const size_t first = element_count * chunk / chunk_count;
+            const size_t last = element_count * (chunk + 1) / chunk_count;
+            for (size_t i = first; i < last; ++i) {
+                parser.next_ = element_starts[i];
+                result[i] = parser.ParseNode();
+                // Элемент должен заканчиваться ровно перед разделителем, найденным при поиске границ
+                const size_t separator = i + 1 < element_count ? element_starts[i + 1] - 1 : *close_index;
+                if (parser.next_ != separator) {
+                    throw ParsingError("Array parsing error"s);
+                }
+            }
+        });
+        next_ = *close_index + 1;
+        return result;
+    }
+
+    // Записывает индексы начал элементов массива, начиная с текущей позиции, и возвращает индекс закрывающей скобки.
+    // Внутренности строк в индекс не попадают, поэтому достаточно учитывать вложенность скобок.
+    std::optional<size_t> FindElementStarts(std::vector<size_t>& element_starts) const {
+        element_starts.push_back(next_);
+        size_t depth = 0;
+        for (size_t i = next_; i < positions_.size(); ++i) {
+            switch (text_[positions_[i]]) {
+                case '[':
+                case '{':
+                    ++depth;
+                    break;
+                case ']':
+                case '}':
+                    if (depth == 0) {
+                        return i;
+                    }
+                    --depth;
+                    break;
+                case ',':
+                    if (depth == 0) {
+                        element_starts.push_back(i + 1);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        return std::nullopt;
+    }
+
+    Node ParseDict() {
+        std::vector<Dict::Item> items;
+        if (Peek() == '}') {
+            ++next_;
+            return Dict{};
+        }
+        ++depth_;
+        while (true) {
+            const size_t key_position = NextPosition();
+            if (text_[key_position] != '"') {
+                throw ParsingError(R"(String key is expected but ')"s + text_[key_position] + "' has been found"s);
+            }
+            std::string_view key = ParseStringView(key_position);
+            if (char c = text_[NextPosition()]; c != ':') {
+                throw ParsingError(": is expected but '"s + c + "' has been found"s);
+            }
+            items.emplace_back(key, ParseNode());
+
+            const char c = text_[NextPosition()];
+            if (c == '}') {
+                break;
+            }
+            if (c != ',') {
+                throw ParsingError(R"(',' is expected but ')"s + c + "' has been found"s);
+            }
+        }
+        --depth_;
+
+        SortByKey(items);
+        auto duplicate = std::adjacent_find(items.begin(), items.end(), [](const Dict::Item& lhs, const Dict::Item& rhs) {
+            return lhs.first == rhs.first;
+        });
+        if (duplicate != items.end()) {
+            throw ParsingError("Duplicate key '"s + std::string(duplicate->first) + "' have been found");
+        }
+        return Dict{ std::move(items) };
+    }
+
+    // Объекты обычно небольшие, поэтому для них достаточно устойчивой сортировки вставками без выделения памяти
+    static void SortByKey(std::vector<Dict::Item>& items) {
+        constexpr size_t INSERTION_SORT_LIMIT = 16;
+        auto key_less = [](const Dict::Item& lhs, const Dict::Item& rhs) {
+            return lhs.first < rhs.first;
+        };
+        if (items.size() > INSERTION_SORT_LIMIT) {
+            std::stable_sort(items.begin(), items.end(), key_less);
+            return;
+        }
+        for (auto it = items.begin(); it != items.end(); ++it) {
+            auto insert_pos = std::upper_bound(items.begin(), it, *it, key_less);
+            std::rotate(insert_pos, it, std::next(it));
+        }
+    }
+
+    Node ParseString(size_t open_position) {
+        return ParseStringView(open_position);
+    }
+
+    // Закрывающая кавычка — следующая позиция индекса. Строка копируется, только если в ней есть escape-последовательности.
+    std::string_view ParseStringView(size_t open_position) {
+        const size_t close_position = NextPosition();
+        const char* begin = text_.data() + open_position + 1;
+        const size_t size = close_position - open_position - 1;
+        if (std::memchr(begin, '\\', size) == nullptr) {
+            return { begin, size };
+        }
+        return Unescape({ begin, size });
+    }
+
+    std::string_view Unescape(std::string_view raw) {
+        std::string s;
+        s.reserve(raw.size());
+        for (auto it = raw.begin(); it != raw.end(); ++it) {
+            if (*it != '\\') {
+                s.push_back(*it);
+                continue;
+            }
+            const char escaped_char = *++it;
+            switch (escaped_char) {
+                case 'n':
+                    s.push_back('\n');
+                    break;
+                case 't':
+                    s.push_back('\t');
+                    break;
+                case 'r':
+                    s.push_back('\r');
+                    break;
+                case '"':
+                    s.push_back('"');
+                    break;
+                case '\\':
+                    s.push_back('\\');
+                    break;
+                default:
+                    throw ParsingError("Unrecognized escape sequence \\"s + escaped_char);
+            }
+        }
+        return unescaped_strings_.emplace_back(std::move(s));
+    }
+
+    std::string_view ParseLiteral(size_t position) {
+        size_t end = position;
+        while (end != text_.size() && IsAlpha(text_[end])) {
+            ++end;
+        }
+        if (end != text_.size() && !IsScalarEnd(text_[end])) {
+            throw ParsingError("Failed to parse '"s + std::string(text_.substr(position, end - position + 1)) + "'"s);
+        }
+        return text_.substr(position, end - position);
+    }
+
+    Node ParseBool(size_t position) {
+        const auto s = ParseLiteral(position);
+        if (s == "true"sv) {
+            return Node{ true };
+        } else if (s == "false"sv) {
+            return Node{ false };
+        } else {
+            throw ParsingError("Failed to parse '"s + std::string(s) + "' as bool"s);
+        }
+    }
+
+    Node ParseNull(size_t position) {
+        if (auto literal = ParseLiteral(position); literal == "null"sv) {
+            return Node{ nullptr };
+        } else {
+            throw ParsingError("Failed to parse '"s + std::string(literal) + "' as null"s);
+        }
+    }
+
+    Node ParseNumber(size_t position) {
+        const char* const begin = text_.data() + position;
+        const char* const end = text_.data() + text_.size();
+        const char* pos = begin;
+
+        auto parse_digits = [&pos, end] {
+            if (pos == end || !IsDigit(*pos)) {
+                throw ParsingError("A digit is expected"s);
+            }
+            while (pos != end && IsDigit(*pos)) {
+                ++pos;
+            }
+        };
+
+        if (*pos == '-') {
+            ++pos;
+        }
+        if (pos != end && *pos == '0') {
+            ++pos;
+        } else {
+            parse_digits();
+        }
+
+        bool is_int = true;
+        if (pos != end && *pos == '.') {
+            ++pos;
+            parse_digits();
+            is_int = false;
+        }
+        if (pos != end && (*pos == 'e' || *pos == 'E')) {
+            ++pos;
+            if (pos != end && (*pos == '+' || *pos == '-')) {
+                ++pos;
+            }
+            parse_digits();
+            is_int = false;
+        }
+        if (pos != end && !IsScalarEnd(*pos)) {
+            throw ParsingError("Failed to parse number "s + std::string(begin, pos + 1));
+        }
+
+        if (is_int) {
+            int value;
+            if (auto [ptr, ec] = std::from_chars(begin, pos, value); ec == std::errc{} && ptr == pos) {
+                return value;
+            }
+        }
+        double value;
+        if (auto [ptr, ec] = std::from_chars(begin, pos, value); ec == std::errc{} && ptr == pos) {
+            return value;
+        }
+        throw ParsingError("Failed to convert "s + std::string(begin, pos) + " to number"s);
+    }
+
+    std::string_view text_;
+    const std::vector<Offset>& positions_;
+    size_t next_ = 0;
+    size_t depth_ = 0;
+    std::deque<std::deque<std::string>>& string_storages_;
+    std::deque<std::string>& unescaped_strings_;
+    parallel::ThreadPool* pool_;
+};
+
+template <typename Offset>
+Node Parse(std::string_view text, std::deque<std::deque<std::string>>& string_storages, size_t thread_count) {
+    const std::vector<Offset> positions = StructuralIndexer<Offset>(text).Build();
+    std::optional<parallel::ThreadPool> pool;
+    if (thread_count > 1 && positions.size() >= Parser<Offset>::PARALLEL_MIN_POSITIONS) {
+        pool.emplace(thread_count);
+    }
+    return Parser<Offset>(text, positions, string_storages, pool ? &*pool : nullptr).ParseDocument();
+}
+
+}  // namespace
+
+Input Input::FromStdin() {
+    Input input;
+#ifdef JSON_VIEW_USE_MMAP
+    if (input.Map(STDIN_FILENO)) {
+        return input;
+    }
+    char chunk[64 * 1024];
+    for (ssize_t size; (size = read(STDIN_FILENO, chunk, sizeof(chunk))) > 0;) {
+        input.buffer_.insert(input.buffer_.end(), chunk, chunk + size);
+    }
+    return input;
+#else
+    return FromStream(std::cin);
+#endif
+}
+
+Input Input::FromFile(const std::string& path) {
+    Input input;
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        throw std::runtime_error("Failed to open "s + path);
+    }
+#ifdef JSON_VIEW_USE_MMAP
+    const bool is_mapped = input.Map(fileno(file));
+#else
+    const bool is_mapped = false;
+#endif
+    if (!is_mapped) {
+        char chunk[64 * 1024];
+        for (size_t size; (size = std::fread(chunk, 1, sizeof(chunk), file)) > 0;) {
+            input.buffer_.insert(input.buffer_.end(), chunk, chunk + size);
+        }
+    }
+    std::fclose(file);
+    return input;
+}
+
+Input Input::FromStream(std::istream& stream) {
+    Input input;
+    input.buffer_.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    return input;
+}
+
+Input Input::FromStreamValue(std::istream& stream) {
+    Input input;
+    std::streambuf* buffer = stream.rdbuf();
+    using Traits = std::streambuf::traits_type;
+    int ch = buffer->sbumpc();
+    while (ch != Traits::eof() && std::isspace(ch)) {
+        ch = buffer->sbumpc();
+    }
+    // Скобки внутри строк не считаются, а экранированная кавычка не закрывает строку
+    size_t depth = 0;
+    bool in_string = false;
+    for (; ch != Traits::eof(); ch = buffer->sbumpc()) {
+        input.buffer_.push_back(static_cast<char>(ch));
+        if (in_string) {
+            if (ch == '\\') {
+                if (ch = buffer->sbumpc(); ch == Traits::eof()) {
+                    break;
+                }
+                input.buffer_.push_back(static_cast<char>(ch));
+            }
+            else if (ch == '"') {
+                in_string = false;
+            }
+        }
+        else if (ch == '"') {
+            in_string = true;
+        }
+        else if (ch == '{' || ch == '[') {
+            ++depth;
+        }
+        else if ((ch == '}' || ch == ']') && depth > 0 && --depth == 0) {
+            break;
+        }
+        else if (depth == 0 && std::isspace(buffer->sgetc())) {
+            // Значение верхнего уровня без скобок заканчивается на пробельном символе
+            break;
+        }
+    }
+    if (ch == Traits::eof()) {
+        stream.setstate(std::ios::eofbit);
+    }
+    return input;
+}
+
+Input Input::FromString(std::string_view text) {
+    Input input;
+    input.buffer_.assign(text.begin(), text.end());
+    return input;
+}
+
+Input::Input(Input&& other) noexcept
+    : mapping_(std::exchange(other.mapping_, nullptr))
+    , mapping_size_(std::exchange(other.mapping_size_, 0))
+    , offset_(std::exchange(other.offset_, 0))
+    , buffer_(std::move(other.buffer_)) {
+}
+
+Input& Input::operator=(Input&& other) noexcept {
+    if (this != &other) {
+        Unmap();
+        mapping_ = std::exchange(other.mapping_, nullptr);
+        mapping_size_ = std::exchange(other.mapping_size_, 0);
+        offset_ = std::exchange(other.offset_, 0);
+        buffer_ = std::move(other.buffer_);
+    }
+    return *this;
+}
+
+Input::~Input() {
+    Unmap();
+}
+
+std::string_view Input::GetText() const {
+    if (mapping_) {
+        return { static_cast<const char*>(mapping_) + offset_, mapping_size_ - offset_ };
+    }
+    return { buffer_.data(), buffer_.size() };
+}
+
+// Отображает в память обычный файл, начиная с текущей позиции дескриптора
+bool Input::Map(int fd) {
+#ifdef JSON_VIEW_USE_MMAP
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode) || file_stat.st_size == 0) {
+        return false;
+    }
+    const off_t offset = lseek(fd, 0, SEEK_CUR);
+    if (offset < 0 || offset >= file_stat.st_size) {
+        return false;
+    }
+    const size_t size = static_cast<size_t>(file_stat.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    mapping_ = mapping;
+    mapping_size_ = size;
+    offset_ = static_cast<size_t>(offset);
+    return true;
+#else
+    (void)fd;
+    return false;
+#endif
+}
+
+void Input::Unmap() {
+#ifdef JSON_VIEW_USE_MMAP
+    if (mapping_) {
+        munmap(mapping_, mapping_size_);
+    }
+#endif
+    mapping_ = nullptr;
+}
+
+Document::Document(Input input, size_t thread_count)
+    : input_(std::move(input)) {
+    const std::string_view text = input_.GetText();
+    // 32-битных смещений хватает для документов до 4 ГиБ, для больших индекс строится на 64-битных
+    if (text.size() <= std::numeric_limits<uint32_t>::max()) {
+        root_ = Parse<uint32_t>(text, unescaped_strings_, thread_count);
+    } else {
+        root_ = Parse<uint64_t>(text, unescaped_strings_, thread_count);
+    }
+}
+
+Document Load(Input input, size_t thread_count) {
+    return Document{ std::move(input), thread_count };
+}
+
+}  // namespace json::view
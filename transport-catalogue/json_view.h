@@ -0,0 +1,216 @@
+#pragma once
+
+#include "json.h"
+
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Неизменяемый DOM для чтения входных JSON-документов без копирования строк.
+// Строковые значения и ключи — это string_view на текст документа; строки с escape-последовательностями
+// раскодируются при разборе в хранилище документа, остальные не копируются вовсе.
+namespace json::view {
+
+class Node;
+using Array = std::vector<Node>;
+
+// Словарь в виде отсортированного по ключу вектора пар
+class Dict {
+public:
+    using Item = std::pair<std::string_view, Node>;
+    using const_iterator = std::vector<Item>::const_iterator;
+
+    Dict() = default;
+    explicit Dict(std::vector<Item> items);
+
+    const Node& at(std::string_view key) const;
+    const Node* Find(std::string_view key) const;
+    size_t count(std::string_view key) const;
+
+    const_iterator begin() const {
+        return items_.begin();
+    }
+    const_iterator end() const {
+        return items_.end();
+    }
+    size_t size() const {
+        return items_.size();
+    }
+    bool empty() const {
+        return items_.empty();
+    }
+
+private:
+    std::vector<Item> items_;
+};
+
+class Node final
+    : private std::variant<std::nullptr_t, Array, Dict, bool, int, double, std::string_view> {
+public:
+    using variant::variant;
+    using Value = variant;
+
+    bool IsInt() const {
+        return std::holds_alternative<int>(*this);
+    }
+    int AsInt() const {
+        using namespace std::literals;
+        if (!IsInt()) {
+            throw std::logic_error("Not an int"s);
+        }
+        return std::get<int>(*this);
+    }
+
+    bool IsPureDouble() const {
+        return std::holds_alternative<double>(*this);
+    }
+    bool IsDouble() const {
+        return IsInt() || IsPureDouble();
+    }
+    double AsDouble() const {
+        using namespace std::literals;
+        if (!IsDouble()) {
+            throw std::logic_error("Not a double"s);
+        }
+        return IsPureDouble() ? std::get<double>(*this) : AsInt();
+    }
+
+    bool IsBool() const {
+        return std::holds_alternative<bool>(*this);
+    }
+    bool AsBool() const {
+        using namespace std::literals;
+        if (!IsBool()) {
+            throw std::logic_error("Not a bool"s);
+        }
+        return std::get<bool>(*this);
+    }
+
+    bool IsNull() const {
+        return std::holds_alternative<std::nullptr_t>(*this);
+    }
+
+    bool IsArray() const {
+        return std::holds_alternative<Array>(*this);
+    }
+    const Array& AsArray() const {
+        using namespace std::literals;
+        if (!IsArray()) {
+            throw std::logic_error("Not an array"s);
+        }
+        return std::get<Array>(*this);
+    }
+
+    bool IsString() const {
+        return std::holds_alternative<std::string_view>(*this);
+    }
+    std::string_view AsString() const {
+        using namespace std::literals;
+        if (!IsString()) {
+            throw std::logic_error("Not a string"s);
+        }
+        return std::get<std::string_view>(*this);
+    }
+
+    bool IsDict() const {
+        return std::holds_alternative<Dict>(*this);
+    }
+    const Dict& AsDict() const {
+        using namespace std::literals;
+        if (!IsDict()) {
+            throw std::logic_error("Not a dict"s);
+        }
+        return std::get<Dict>(*this);
+    }
+
+    const Value& GetValue() const {
+        return *this;
+    }
+};
+
+inline Dict::Dict(std::vector<Item> items)
+    : items_(std::move(items)) {
+}
+
+inline const Node* Dict::Find(std::string_view key) const {
+    auto it = std::lower_bound(items_.begin(), items_.end(), key, [](const Item& item, std::string_view key) {
+        return item.first < key;
+    });
+    if (it == items_.end() || it->first != key) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+inline const Node& Dict::at(std::string_view key) const {
+    using namespace std::literals;
+    if (const Node* node = Find(key)) {
+        return *node;
+    }
+    throw std::out_of_range("Key '"s + std::string(key) + "' not found"s);
+}
+
+inline size_t Dict::count(std::string_view key) const {
+    return Find(key) ? 1 : 0;
+}
+
+// Текст входного документа: отображение файла в память, если вход — обычный файл,
+// иначе буфер с прочитанными данными
+class Input {
+public:
+    static Input FromStdin();
+    static Input FromFile(const std::string& path);
+    static Input FromStream(std::istream& input);
+    // Только первое значение JSON из потока: объект или массив читается до парной закрывающей скобки,
+    // остаток потока остаётся непрочитанным
+    static Input FromStreamValue(std::istream& input);
+    static Input FromString(std::string_view text);
+
+    Input(Input&& other) noexcept;
+    Input& operator=(Input&& other) noexcept;
+    Input(const Input&) = delete;
+    Input& operator=(const Input&) = delete;
+    ~Input();
+
+    std::string_view GetText() const;
+
+private:
+    Input() = default;
+    bool Map(int fd);
+    void Unmap();
+
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    size_t offset_ = 0;
+    std::vector<char> buffer_;
+};
+
+class Document {
+public:
+    // Большие массивы верхних уровней документа разбираются в thread_count потоков
+    explicit Document(Input input, size_t thread_count = std::thread::hardware_concurrency());
+
+    Document(Document&&) = default;
+    Document& operator=(Document&&) = default;
+
+    const Node& GetRoot() const {
+        return root_;
+    }
+
+private:
+    Input input_;
+    // Раскодированные строки с escape-последовательностями, по хранилищу на каждый поток разбора
+    std::deque<std::deque<std::string>> unescaped_strings_;
+    Node root_;
+};
+
+Document Load(Input input, size_t thread_count = std::thread::hardware_concurrency());
+
+}  // namespace json::view
@@ -8,11 +8,32 @@
 
 using namespace std;
 
-int main() {
+// Флаги командной строки:
+// --compact — вывод ответов без пробелов и переводов строк;
+// --stream — потоковый режим: ввод начинается с документа с базой и настройками, каждая следующая строка — один запрос;
+// --stats — после обработки вывести в stderr сводку о расходе памяти и размере графа маршрутов
+int main(int argc, char* argv[]) {
+    bool is_compact = false;
+    bool is_stream = false;
+    bool print_stats = false;
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i] == "--compact"sv) {
+            is_compact = true;
+        } else if (argv[i] == "--stream"sv) {
+            is_stream = true;
+        } else if (argv[i] == "--stats"sv) {
+            print_stats = true;
+        }
+    }
     TransportCatalogue catalogue;
     RequestHandler req_handler(catalogue);
-    json_reader::JSON_Reader reader;
-    MapRenderer map_renderer(req_handler);
-    TransportRouter router(catalogue);
-    reader.ReadRequests(cin, catalogue, req_handler, map_renderer, router);
+    json_reader::JSON_Reader reader(is_compact ? json::PrintMode::COMPACT : json::PrintMode::PRETTY);
+    if (is_stream) {
+        reader.ReadStreamRequests(cin, catalogue, req_handler);
+    } else {
+        reader.ReadRequests(json::view::Input::FromStdin(), catalogue, req_handler);
+    }
+    if (print_stats) {
+        reader.PrintStats(catalogue, cerr);
+    }
 }
@@ -5,26 +5,22 @@ bool IsZero(double value) {
     return std::abs(value) < EPSILON;
 }
 
-void MapRenderer::DrawLines(SphereProjector& proj) {
+void MapRenderer::DrawLines(svg::Document& document, SphereProjector& proj) {
+	const CatalogueLayout& layout = handler_.GetLayout();
 	int color_index = 0;
 	size_t max_color_index = properties_.color_palette.size();
 
-	for (const auto& bus : handler_.GetAllBuses()) {
+	for (uint32_t bus_id : handler_.GetAllBuses()) {
 		if (color_index == (int)max_color_index) {
 			color_index = 0;
 		}
-		std::vector<geo::Coordinates> geo_coords;
 		svg::Polyline line;
 
-		for (const auto& stop : bus.stops) {
-			geo_coords.push_back(stop->coordinates);
+		for (uint32_t stop_id : layout.GetBusStops(bus_id)) {
+			line.AddPoint(proj(layout.GetStopCoordinates(stop_id)));
 		}
 
-		for (const auto& coord : geo_coords) {
-			line.AddPoint(proj(coord));
-		}
-
-		document_.Add(line.SetFillColor("none")
+		document.Add(line.SetFillColor("none")
 			.SetStrokeColor(properties_.color_palette[color_index])
 			.SetStrokeWidth(properties_.line_width)
 			.SetStrokeLineCap(svg::StrokeLineCap::ROUND)
@@ -33,20 +29,22 @@ void MapRenderer::DrawLines(SphereProjector& proj) {
 	}
 }
 
-void MapRenderer::DrawBusNames(SphereProjector& proj) {
+void MapRenderer::DrawBusNames(svg::Document& document, SphereProjector& proj) {
+	const CatalogueLayout& layout = handler_.GetLayout();
 	int color_index = 0;
 	size_t max_color_index = properties_.color_palette.size();
-	for (const auto& bus : handler_.GetAllBuses()) {
+	for (uint32_t bus_id : handler_.GetAllBuses()) {
 		if (color_index == (int)max_color_index) {
 			color_index = 0;
 		}
+		const CatalogueLayout::IdRange stops = layout.GetBusStops(bus_id);
 		svg::Text bus_name;
-		bus_name.SetData(bus.bus_num);
+		bus_name.SetData(std::string{ layout.GetBusName(bus_id) });
 		bus_name.SetOffset({ properties_.bus_label_offset[0], properties_.bus_label_offset[1] });
 		bus_name.SetFontSize(properties_.bus_label_font_size);
 		bus_name.SetFontFamily("Verdana");
 		bus_name.SetFontWeight("bold");
-		bus_name.SetPosition({ proj(bus.stops[0]->coordinates) });
+		bus_name.SetPosition({ proj(layout.GetStopCoordinates(stops.begin()[0])) });
 		bus_name.SetFillColor(properties_.color_palette[color_index]);
 
 		svg::Text bus_background = bus_name;
@@ -56,12 +54,13 @@ void MapRenderer::DrawBusNames(SphereProjector& proj) {
 			.SetStrokeLineCap(svg::StrokeLineCap::ROUND)
 			.SetStrokeLineJoin(svg::StrokeLineJoin::ROUND);
 		
-		document_.Add(bus_background);
-		document_.Add(bus_name);
+		document.Add(bus_background);
+		document.Add(bus_name);
 
-		if (!bus.is_roundtrip && (bus.stops[bus.stops.size() / 2] != bus.stops[0])) {
+		const uint32_t middle_stop_id = stops.begin()[stops.size() / 2];
+		if (!layout.IsRoundtrip(bus_id) && (middle_stop_id != stops.begin()[0])) {
 			svg::Text bus_name_end = bus_name;
-			bus_name_end.SetPosition({ proj(bus.stops[bus.stops.size() / 2]->coordinates) });
+			bus_name_end.SetPosition({ proj(layout.GetStopCoordinates(middle_stop_id)) });
 
 			svg::Text bus_background_end = bus_name_end;
 			bus_background_end.SetFillColor(properties_.underlayer_color)
@@ -70,31 +69,33 @@ void MapRenderer::DrawBusNames(SphereProjector& proj) {
 				.SetStrokeLineCap(svg::StrokeLineCap::ROUND)
 				.SetStrokeLineJoin(svg::StrokeLineJoin::ROUND);
 			
-			document_.Add(bus_background_end);
-			document_.Add(bus_name_end);
+			document.Add(bus_background_end);
+			document.Add(bus_name_end);
 		}
 		color_index++;
 	}
 }
 
-void MapRenderer::DrawStops(SphereProjector& proj) {
+void MapRenderer::DrawStops(svg::Document& document, SphereProjector& proj) {
 	svg::Circle circle;
 	circle.SetFillColor("white")
 		.SetRadius(properties_.stop_radius);
-	for (const auto& coord : coordinates_) {
-		circle.SetCenter({ proj(coord) });
-		document_.Add(circle);
+	const CatalogueLayout& layout = handler_.GetLayout();
+	for (uint32_t stop_id : stop_ids_) {
+		circle.SetCenter({ proj(layout.GetStopCoordinates(stop_id)) });
+		document.Add(circle);
 	}
 }
 
-void MapRenderer::DrawStopNames(SphereProjector& proj) {
-	for (const auto& stop : handler_.GetAllStops()) {
+void MapRenderer::DrawStopNames(svg::Document& document, SphereProjector& proj) {
+	const CatalogueLayout& layout = handler_.GetLayout();
+	for (uint32_t stop_id : stop_ids_) {
 		svg::Text stop_name;
-		stop_name.SetData(stop.name)
+		stop_name.SetData(std::string{ layout.GetStopName(stop_id) })
 			.SetOffset({ properties_.stop_label_offset[0], properties_.stop_label_offset[1] })
 			.SetFontSize(properties_.stop_label_font_size)
 			.SetFontFamily("Verdana")
-			.SetPosition({ proj(stop.coordinates) })
+			.SetPosition({ proj(layout.GetStopCoordinates(stop_id)) })
 			.SetFillColor("black");
 
 		svg::Text stop_background = stop_name;
@@ -104,27 +105,34 @@ void MapRenderer::DrawStopNames(SphereProjector& proj) {
 			.SetStrokeLineCap(svg::StrokeLineCap::ROUND)
 			.SetStrokeLineJoin(svg::StrokeLineJoin::ROUND);
 
-		document_.Add(stop_background);
-		document_.Add(stop_name);
+		document.Add(stop_background);
+		document.Add(stop_name);
 	}
 }
 
-void MapRenderer::DrawMap(std::ostringstream& out) {
-	for (const auto& stop : handler_.GetAllStops()) {
-		coordinates_.push_back(stop.coordinates);
+void MapRenderer::DrawMap(std::ostream& out) {
+	// Каждая карта рисуется в свой документ, а не поверх предыдущей
+	svg::Document document;
+	const CatalogueLayout& layout = handler_.GetLayout();
+	stop_ids_ = handler_.GetAllStops();
+	// Проекции нужны только границы, поэтому вместо координат всех остановок ей передаются два угла
+	std::vector<geo::Coordinates> corners;
+	if (!stop_ids_.empty()) {
+		const auto [min_corner, max_corner] = layout.GetStopBounds(stop_ids_);
+		corners = { min_corner, max_corner };
 	}
 
-	SphereProjector proj{ coordinates_.begin(),
-						coordinates_.end(),
+	SphereProjector proj{ corners.begin(),
+						corners.end(),
 						properties_.width,
 						properties_.height,
 						properties_.padding };
 
-	DrawLines(proj);
-	DrawBusNames(proj);
-	DrawStops(proj);
-	DrawStopNames(proj);
-	document_.Render(out);
+	DrawLines(document, proj);
+	DrawBusNames(document, proj);
+	DrawStops(document, proj);
+	DrawStopNames(document, proj);
+	document.Render(out);
 }
 
 MapRenderer& MapRenderer::SetWidth(double width) {
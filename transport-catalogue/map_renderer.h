@@ -107,11 +107,11 @@ public:
     : handler_(handler) {
     }
 
-    void DrawMap(std::ostringstream& out);
-    void DrawLines(SphereProjector& proj);
-    void DrawBusNames(SphereProjector& proj);
-    void DrawStops(SphereProjector& proj);
-    void DrawStopNames(SphereProjector& proj);
+    void DrawMap(std::ostream& out);
+    void DrawLines(svg::Document& document, SphereProjector& proj);
+    void DrawBusNames(svg::Document& document, SphereProjector& proj);
+    void DrawStops(svg::Document& document, SphereProjector& proj);
+    void DrawStopNames(svg::Document& document, SphereProjector& proj);
 
     MapRenderer& SetWidth(double width);
     MapRenderer& SetHeight(double height);
@@ -127,8 +127,8 @@ public:
     MapRenderer& SetColorPalette(std::vector<svg::Color> color_palette);
 
 private:
-    svg::Document document_;
-    std::vector<geo::Coordinates> coordinates_;
+    // Остановки, через которые проходят маршруты, в порядке названий
+    std::vector<uint32_t> stop_ids_;
     MapProps properties_;
     RequestHandler& handler_;
 };
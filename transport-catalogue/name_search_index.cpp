@@ -0,0 +1,190 @@
+#include "name_search_index.h"
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace transport_catalogue
+{
+	namespace {
+
+	// Раскодирует UTF-8; байт, который не начинает корректную последовательность, считается отдельным символом
+	void AppendCodePoints(std::string_view text, std::vector<char32_t>& code_points) {
+		for (size_t i = 0; i < text.size();) {
+			const unsigned char lead = static_cast<unsigned char>(text[i]);
+			const size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+			bool is_valid = length != 0 && i + length <= text.size();
+			char32_t code_point = length == 1 ? lead : lead & (0x7F >> length);
+			for (size_t j = 1; is_valid && j < length; ++j) {
+				const unsigned char next = static_cast<unsigned char>(text[i + j]);
+				is_valid = (next >> 6) == 0x2;
+				code_point = (code_point << 6) | (next & 0x3F);
+			}
+			if (!is_valid) {
+				code_points.push_back(lead);
+				++i;
+				continue;
+			}
+			code_points.push_back(code_point);
+			i += length;
+		}
+	}
+
+	}
+
+	NameSearchIndex::NameSearchIndex(std::vector<std::string_view> names)
+		: names_(std::move(names)) {
+		std::sort(names_.begin(), names_.end());
+		names_.erase(std::unique(names_.begin(), names_.end()), names_.end());
+		code_point_offsets_.reserve(names_.size() + 1);
+		code_point_offsets_.push_back(0);
+		for (std::string_view name : names_) {
+			AppendCodePoints(name, code_points_);
+			code_point_offsets_.push_back(static_cast<uint32_t>(code_points_.size()));
+		}
+		if (names_.empty()) {
+			return;
+		}
+		// common_lengths[i] — длина общего начала названий i - 1 и i в символах
+		std::vector<uint32_t> common_lengths(names_.size(), 0);
+		for (size_t i = 1; i < names_.size(); ++i) {
+			const char32_t* previous = GetCodePoints(i - 1);
+			const char32_t* current = GetCodePoints(i);
+			const size_t max_length = std::min(GetLength(i - 1), GetLength(i));
+			while (common_lengths[i] < max_length && previous[common_lengths[i]] == current[common_lengths[i]]) {
+				++common_lengths[i];
+			}
+		}
+		BuildNodes(common_lengths, 0, static_cast<uint32_t>(names_.size()), 0);
+	}
+
+	// Узел для названий [names_begin, names_end) с общим началом не короче depth_begin
+	void NameSearchIndex::BuildNodes(const std::vector<uint32_t>& common_lengths, uint32_t names_begin, uint32_t names_end, uint32_t depth_begin) {
+		uint32_t depth_end = static_cast<uint32_t>(GetLength(names_begin));
+		for (uint32_t i = names_begin + 1; i < names_end; ++i) {
+			depth_end = std::min(depth_end, common_lengths[i]);
+		}
+		const size_t node_index = nodes_.size();
+		const char32_t first_code_point = depth_begin < depth_end ? GetCodePoints(names_begin)[depth_begin] : 0;
+		nodes_.push_back({ names_begin, names_end, depth_begin, depth_end, 0, first_code_point });
+
+		// Название, которое заканчивается в этом узле, идёт первым; остальные делятся на поддеревья по следующему символу
+		uint32_t child_begin = GetLength(names_begin) == depth_end ? names_begin + 1 : names_begin;
+		for (uint32_t i = child_begin + 1; i < names_end; ++i) {
+			if (common_lengths[i] == depth_end) {
+				BuildNodes(common_lengths, child_begin, i, depth_end);
+				child_begin = i;
+			}
+		}
+		if (child_begin < names_end) {
+			BuildNodes(common_lengths, child_begin, names_end, depth_end);
+		}
+		nodes_[node_index].subtree_end = static_cast<uint32_t>(nodes_.size());
+	}
+
+	std::vector<std::string_view> NameSearchIndex::FindByPrefix(std::string_view prefix, size_t limit) const {
+		std::vector<std::string_view> result;
+		for (auto it = std::lower_bound(names_.begin(), names_.end(), prefix);
+			it != names_.end() && result.size() < limit && it->substr(0, prefix.size()) == prefix; ++it) {
+			result.push_back(*it);
+		}
+		return result;
+	}
+
+	std::vector<std::string_view> NameSearchIndex::FindFuzzy(std::string_view query, int max_distance, size_t limit) const {
+		std::vector<char32_t> query_code_points;
+		AppendCodePoints(query, query_code_points);
+		if (max_distance < 0 || limit == 0) {
+			return {};
+		}
+		// До пустого начала названия расстояние равно длине запроса, поэтому большие пороги не нужны
+		max_distance = std::min(max_distance, static_cast<int>(query_code_points.size()));
+
+		// Порог повышается по одному: обход с меньшим порогом отсекает поддеревья раньше, а если он уже нашёл limit
+		// названий, более далёкие в ответ не попадут. Иначе обход с большим порогом найдёт их заново
+		std::vector<std::pair<int, uint32_t>> matches;
+		for (int threshold = 0; threshold <= max_distance; ++threshold) {
+			matches.clear();
+			CollectFuzzyMatches(query_code_points, threshold, limit, matches);
+			if (matches.size() >= limit) {
+				break;
+			}
+		}
+
+		const size_t result_size = std::min(limit, matches.size());
+		std::partial_sort(matches.begin(), matches.begin() + result_size, matches.end());
+		std::vector<std::string_view> result;
+		result.reserve(result_size);
+		for (size_t i = 0; i < result_size; ++i) {
+			result.push_back(names_[matches[i].second]);
+		}
+		return result;
+	}
+
+	void NameSearchIndex::CollectFuzzyMatches(const std::vector<char32_t>& query_code_points, int max_distance, size_t limit,
+		std::vector<std::pair<int, uint32_t>>& matches) const {
+		const size_t width = query_code_points.size() + 1;
+		// Строка d таблицы — расстояния от первых d символов текущего пути в дереве до каждого начала запроса,
+		// best[d] — расстояние от запроса до ближайшего из начал пути длиной не больше d
+		std::vector<int> rows(width);
+		std::iota(rows.begin(), rows.end(), 0);
+		std::vector<int> best{ rows.back() };
+
+		// Для каждого расстояния достаточно первых limit совпадений в порядке названий
+		std::vector<size_t> match_counts(max_distance + 1, 0);
+		auto add_matches = [&](int distance, size_t begin, size_t end) {
+			for (size_t index = begin; index < end && match_counts[distance] < limit; ++index, ++match_counts[distance]) {
+				matches.emplace_back(distance, static_cast<uint32_t>(index));
+			}
+		};
+
+		for (size_t node_index = 0; node_index < nodes_.size();) {
+			const Node& node = nodes_[node_index];
+			// Строки до depth_begin посчитаны для пути к родителю и остаются верными
+			rows.resize((node.depth_end + 1) * width);
+			best.resize(node.depth_begin + 1);
+
+			bool is_settled = false;
+			for (size_t depth = node.depth_begin; depth < node.depth_end; ++depth) {
+				// Расстояние между началами длиной depth + 1 и j не меньше |depth + 1 - j|, поэтому считается только
+				// полоса шириной 2 * max_distance + 1; значения больше max_distance заменяются на cap
+				const int cap = max_distance + 1;
+				const size_t band_begin = depth + 1 > static_cast<size_t>(max_distance) ? depth + 1 - max_distance : 1;
+				const size_t band_end = std::min(width, depth + 2 + max_distance);
+				const int* previous_row = &rows[depth * width];
+				int* row = &rows[(depth + 1) * width];
+				row[0] = std::min(static_cast<int>(depth + 1), cap);
+				if (band_begin > 1) {
+					row[band_begin - 1] = cap;
+				}
+				int row_min = row[0];
+				const char32_t code_point = depth == node.depth_begin ? node.first_code_point : GetCodePoints(node.names_begin)[depth];
+				for (size_t j = band_begin; j < band_end; ++j) {
+					row[j] = std::min({ previous_row[j] + 1, row[j - 1] + 1,
+						previous_row[j - 1] + (code_point == query_code_points[j - 1] ? 0 : 1), cap });
+					row_min = std::min(row_min, row[j]);
+				}
+				if (band_end < width) {
+					row[band_end] = cap;
+				}
+				best.push_back(std::min(best.back(), band_end == width ? row[width - 1] : cap));
+				// Дальше расстояние не уменьшится: все названия поддерева либо не подходят,
+				// либо подходят с расстоянием best.back()
+				if (row_min > max_distance || best.back() <= row_min) {
+					is_settled = true;
+					break;
+				}
+			}
+			if (is_settled) {
+				if (best.back() <= max_distance) {
+					add_matches(best.back(), node.names_begin, node.names_end);
+				}
+				node_index = node.subtree_end;
+				continue;
+			}
+			if (GetLength(node.names_begin) == node.depth_end && best.back() <= max_distance) {
+				add_matches(best.back(), node.names_begin, node.names_begin + 1);
+			}
+			++node_index;
+		}
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace transport_catalogue
+{
+    // Индекс для поиска по началу названия: отсортированные названия и сжатое префиксное дерево над ними.
+    // Поиск по точному началу — двоичный поиск в отсортированных названиях. Неточный поиск обходит дерево,
+    // считая по строке таблицы расстояний Левенштейна на символ, и пропускает поддерево целиком,
+    // как только расстояние в нём больше не может уменьшиться. Порог расстояния повышается от нуля,
+    // пока не наберётся нужное число названий: обход с малым порогом отсекает поддеревья у самого корня.
+    // Расстояние считается по символам Unicode, названия — в UTF-8.
+    class NameSearchIndex {
+    public:
+        explicit NameSearchIndex(std::vector<std::string_view> names);
+
+        // Не более limit названий, начинающихся с prefix, в порядке названий
+        std::vector<std::string_view> FindByPrefix(std::string_view prefix, size_t limit) const;
+        // Не более limit названий, начало которых отличается от query не более чем на max_distance правок
+        // (вставка, удаление или замена символа). Ближайшие идут первыми, при равенстве — в порядке названий.
+        std::vector<std::string_view> FindFuzzy(std::string_view query, int max_distance, size_t limit) const;
+
+    private:
+        // Узел сжатого дерева. Узлы хранятся в порядке обхода в глубину, который совпадает с порядком названий,
+        // поэтому поддерево — отрезок узлов [индекс узла, subtree_end), а его названия — отрезок [names_begin, names_end).
+        // Метка ребра в узел — символы [depth_begin, depth_end) названия names_begin. Первый её символ хранится
+        // в узле: обычно обход отсекает узел уже по нему и не читает символы названия.
+        struct Node {
+            uint32_t names_begin;
+            uint32_t names_end;
+            uint32_t depth_begin;
+            uint32_t depth_end;
+            uint32_t subtree_end;
+            char32_t first_code_point;
+        };
+
+        const char32_t* GetCodePoints(size_t name_index) const {
+            return code_points_.data() + code_point_offsets_[name_index];
+        }
+        size_t GetLength(size_t name_index) const {
+            return code_point_offsets_[name_index + 1] - code_point_offsets_[name_index];
+        }
+        // Добавляет в matches пары (расстояние, номер названия) для названий не дальше max_distance от запроса:
+        // для каждого расстояния не более limit первых в порядке названий
+        void CollectFuzzyMatches(const std::vector<char32_t>& query_code_points, int max_distance, size_t limit,
+            std::vector<std::pair<int, uint32_t>>& matches) const;
+        void BuildNodes(const std::vector<uint32_t>& common_lengths, uint32_t names_begin, uint32_t names_end, uint32_t depth_begin);
+
+        // Символы i-го названия — отрезок [code_point_offsets_[i], code_point_offsets_[i + 1]) массива code_points_
+        std::vector<std::string_view> names_;
+        std::vector<uint32_t> code_point_offsets_;
+        std::vector<char32_t> code_points_;
+        std::vector<Node> nodes_;
+    };
+}
@@ -0,0 +1,96 @@
+#include "perfect_hash.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace transport_catalogue
+{
+	std::vector<uint32_t> PerfectHash::Build(const std::vector<std::string_view>& keys) {
+		using namespace std::literals;
+		slot_count_ = keys.size();
+		pilots_.assign(std::max<size_t>(keys.size() / BUCKET_SIZE, 1), 0);
+		std::vector<uint64_t> hashes(keys.size());
+		std::vector<uint32_t> slots(keys.size());
+		// Если для какой-то корзины пилот не нашёлся, построение повторяется с другим начальным значением хеша
+		for (uint64_t seed = 1; seed <= 16; ++seed) {
+			seed_hash_ = Mix(seed);
+			for (size_t i = 0; i < keys.size(); ++i) {
+				hashes[i] = HashKey(keys[i]);
+			}
+			if (TryBuild(hashes, slots)) {
+				return slots;
+			}
+		}
+		throw std::invalid_argument("Keys are not unique"s);
+	}
+
+	bool PerfectHash::TryBuild(const std::vector<uint64_t>& hashes, std::vector<uint32_t>& slots) {
+		// Ключи, упорядоченные по корзинам: корзина i занимает отрезок [bucket_starts[i], bucket_starts[i + 1])
+		const size_t bucket_count = pilots_.size();
+		std::vector<uint32_t> bucket_starts(bucket_count + 1, 0);
+		for (uint64_t hash : hashes) {
+			++bucket_starts[Reduce(hash, bucket_count) + 1];
+		}
+		for (size_t i = 0; i < bucket_count; ++i) {
+			bucket_starts[i + 1] += bucket_starts[i];
+		}
+		std::vector<uint32_t> bucket_keys(hashes.size());
+		{
+			std::vector<uint32_t> positions(bucket_starts.begin(), bucket_starts.end() - 1);
+			for (size_t i = 0; i < hashes.size(); ++i) {
+				bucket_keys[positions[Reduce(hashes[i], bucket_count)]++] = static_cast<uint32_t>(i);
+			}
+		}
+
+		// Большие корзины размещаются первыми, пока свободных позиций много
+		std::vector<uint32_t> bucket_order(bucket_count);
+		for (size_t i = 0; i < bucket_count; ++i) {
+			bucket_order[i] = static_cast<uint32_t>(i);
+		}
+		std::stable_sort(bucket_order.begin(), bucket_order.end(), [&bucket_starts](uint32_t lhs, uint32_t rhs) {
+			return bucket_starts[lhs + 1] - bucket_starts[lhs] > bucket_starts[rhs + 1] - bucket_starts[rhs];
+		});
+
+		std::vector<bool> occupied(slot_count_, false);
+		std::vector<uint32_t> candidate_slots;
+		size_t next_free_slot = 0;
+		for (uint32_t bucket : bucket_order) {
+			const uint32_t begin = bucket_starts[bucket];
+			const uint32_t end = bucket_starts[bucket + 1];
+			if (end - begin == 0) {
+				break;
+			}
+			if (end - begin == 1) {
+				while (occupied[next_free_slot]) {
+					++next_free_slot;
+				}
+				occupied[next_free_slot] = true;
+				slots[bucket_keys[begin]] = static_cast<uint32_t>(next_free_slot);
+				pilots_[bucket] = DIRECT_SLOT | static_cast<uint32_t>(next_free_slot);
+				continue;
+			}
+			uint32_t pilot = 0;
+			for (; pilot < MAX_PILOT; ++pilot) {
+				candidate_slots.clear();
+				for (uint32_t i = begin; i < end; ++i) {
+					const size_t slot = GetPilotSlot(hashes[bucket_keys[i]], pilot);
+					if (occupied[slot] || std::find(candidate_slots.begin(), candidate_slots.end(), slot) != candidate_slots.end()) {
+						break;
+					}
+					candidate_slots.push_back(static_cast<uint32_t>(slot));
+				}
+				if (candidate_slots.size() == end - begin) {
+					break;
+				}
+			}
+			if (pilot == MAX_PILOT) {
+				return false;
+			}
+			pilots_[bucket] = pilot;
+			for (uint32_t i = begin; i < end; ++i) {
+				occupied[candidate_slots[i - begin]] = true;
+				slots[bucket_keys[i]] = candidate_slots[i - begin];
+			}
+		}
+		return true;
+	}
+}
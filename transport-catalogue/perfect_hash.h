@@ -0,0 +1,105 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace transport_catalogue
+{
+    // Минимальная совершенная хеш-функция для неизменного набора различных строк (hash-and-displace).
+    // Ключи распределяются по корзинам в среднем по BUCKET_SIZE ключей; для каждой корзины подбирается
+    // число-пилот, при котором позиции её ключей не заняты другими корзинами. Корзина из одного ключа
+    // хранит его позицию прямо в пилоте. Позиции ключей — числа от 0 до количества ключей без пропусков.
+    // Для строки не из набора возвращается позиция какого-то из ключей, поэтому найденное нужно сравнить с искомым.
+    class PerfectHash {
+    public:
+        // Строит функцию для набора keys и возвращает позицию каждого ключа
+        std::vector<uint32_t> Build(const std::vector<std::string_view>& keys);
+
+        size_t GetSlot(std::string_view key) const {
+            const uint64_t hash = HashKey(key);
+            const uint32_t pilot = pilots_[Reduce(hash, pilots_.size())];
+            if (pilot & DIRECT_SLOT) {
+                return pilot & ~DIRECT_SLOT;
+            }
+            return GetPilotSlot(hash, pilot);
+        }
+
+        size_t GetSlotCount() const {
+            return slot_count_;
+        }
+
+    private:
+        static constexpr size_t BUCKET_SIZE = 4;
+        static constexpr uint32_t DIRECT_SLOT = uint32_t{ 1 } << 31;
+        static constexpr uint32_t MAX_PILOT = 1 << 20;
+        static constexpr uint64_t PILOT_MULTIPLIER = 0x9E3779B97F4A7C15ull;
+        static constexpr uint64_t WORD_MULTIPLIER = 0xbf58476d1ce4e5b9ull;
+
+        // 64-битный хеш с начальным значением независимо от разрядности size_t: от std::hash на 32-битной
+        // платформе старшие биты, по которым Reduce выбирает корзину, были бы одинаковыми у всех ключей.
+        // Строка читается по 8 байт, каждое слово подмешивается умножением, в конце биты перемешиваются Mix
+        uint64_t HashKey(std::string_view key) const {
+            uint64_t hash = seed_hash_ ^ (key.size() * PILOT_MULTIPLIER);
+            size_t pos = 0;
+            for (; pos + sizeof(uint64_t) <= key.size(); pos += sizeof(uint64_t)) {
+                uint64_t word;
+                std::memcpy(&word, key.data() + pos, sizeof(uint64_t));
+                hash = MixWord(hash, word);
+            }
+            if (pos < key.size()) {
+                uint64_t word = 0;
+                std::memcpy(&word, key.data() + pos, key.size() - pos);
+                hash = MixWord(hash, word);
+            }
+            return Mix(hash);
+        }
+        static uint64_t MixWord(uint64_t hash, uint64_t word) {
+            hash = (hash ^ word) * WORD_MULTIPLIER;
+            return hash ^ (hash >> 29);
+        }
+        size_t GetPilotSlot(uint64_t hash, uint32_t pilot) const {
+            return Reduce(Mix(hash ^ (pilot * PILOT_MULTIPLIER)), slot_count_);
+        }
+        // Отображает 64-битный хеш в [0, range) умножением вместо деления
+        static size_t Reduce(uint64_t hash, size_t range) {
+            return static_cast<size_t>(MultiplyHigh(hash, range));
+        }
+        // Старшие 64 бита 128-битного произведения
+        static uint64_t MultiplyHigh(uint64_t lhs, uint64_t rhs) {
+#if defined(__SIZEOF_INT128__)
+            return static_cast<uint64_t>((static_cast<unsigned __int128>(lhs) * rhs) >> 64);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+            return __umulh(lhs, rhs);
+#else
+            // Произведение собирается из четырёх произведений 32-битных половин
+            const uint64_t lhs_low = lhs & 0xFFFFFFFFu;
+            const uint64_t lhs_high = lhs >> 32;
+            const uint64_t rhs_low = rhs & 0xFFFFFFFFu;
+            const uint64_t rhs_high = rhs >> 32;
+            const uint64_t high_low = lhs_high * rhs_low;
+            const uint64_t middle = ((lhs_low * rhs_low) >> 32) + (high_low & 0xFFFFFFFFu) + lhs_low * rhs_high;
+            return lhs_high * rhs_high + (high_low >> 32) + (middle >> 32);
+#endif
+        }
+        // Финализатор MurmurHash3: перемешивает все биты хеша перед отображением в диапазон
+        static uint64_t Mix(uint64_t value) {
+            value ^= value >> 33;
+            value *= 0xff51afd7ed558ccdull;
+            value ^= value >> 33;
+            value *= 0xc4ceb9fe1a85ec53ull;
+            value ^= value >> 33;
+            return value;
+        }
+
+        bool TryBuild(const std::vector<uint64_t>& hashes, std::vector<uint32_t>& slots);
+
+        std::vector<uint32_t> pilots_;
+        size_t slot_count_ = 0;
+        uint64_t seed_hash_ = 0;
+    };
+}
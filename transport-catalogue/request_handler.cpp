@@ -1,13 +1,17 @@
 #include "request_handler.h"
+#include <algorithm>
+#include <iterator>
 
 std::optional<statistics::BusInfo> RequestHandler::GetBusInfo(std::string_view bus_num) const {
-	Bus* founded_bus = db_.GetBus(bus_num);
+	const Bus* founded_bus = db_.GetBus(bus_num);
 	if (!founded_bus) {
 		return std::nullopt;
 	}
-	int road_distance = db_.CountRouteDistance(*founded_bus);
-	statistics::BusInfo bus_info{ founded_bus->bus_num, db_.GetStops(*founded_bus),
-		db_.GetUniqueStops(*founded_bus), road_distance, db_.CountRouteCurvature(*founded_bus, road_distance) };
+	const CatalogueLayout& layout = db_.GetLayout();
+	const uint32_t bus_id = founded_bus->id;
+	int road_distance = layout.GetRouteDistance(bus_id);
+	statistics::BusInfo bus_info{ founded_bus->bus_num, static_cast<int>(layout.GetBusStops(bus_id).size()),
+		layout.GetUniqueStopCount(bus_id), road_distance, road_distance / layout.GetGeoRouteDistance(bus_id) };
 	return bus_info;
 }
 
@@ -18,32 +22,53 @@ std::optional<statistics::StopInfo> RequestHandler::GetStopInfo(std::string_view
 		return std::nullopt;
 	}
 
-	statistics::StopInfo stop_info{ founded_stop->name, {} };
+	return statistics::StopInfo{ founded_stop->name, db_.GetLayout().GetStopBusNames(founded_stop->id) };
+}
 
-	const std::set<std::string_view>* stop_buses = db_.GetStopBuses(founded_stop);
-	if (stop_buses) {
-		stop_info.buses = *stop_buses;
+std::optional<statistics::BusSegmentInfo> RequestHandler::GetBusSegmentInfo(std::string_view bus_num, std::string_view from, std::string_view to) const {
+	const Bus* bus = db_.GetBus(bus_num);
+	const Stop* stop_from = db_.GetStop(from);
+	const Stop* stop_to = db_.GetStop(to);
+	if (!bus || !stop_from || !stop_to) {
+		return std::nullopt;
+	}
+	const CatalogueLayout& layout = db_.GetLayout();
+	const CatalogueLayout::IdRange stops = layout.GetBusStops(bus->id);
+	const auto from_it = std::find(stops.begin(), stops.end(), stop_from->id);
+	if (from_it == stops.end()) {
+		return std::nullopt;
 	}
-	
-	return stop_info;
+	const auto to_it = std::find(std::next(from_it), stops.end(), stop_to->id);
+	if (to_it == stops.end()) {
+		return std::nullopt;
+	}
+	const size_t from_index = from_it - stops.begin();
+	const size_t to_index = to_it - stops.begin();
+	return statistics::BusSegmentInfo{ layout.GetSegmentDistance(bus->id, from_index, to_index), static_cast<int>(to_index - from_index) };
 }
 
-const std::set<Bus> RequestHandler::GetAllBuses() const {
-	std::set<Bus> buses;
-	for (const auto& bus : db_.GetBuses()) {
-		if (bus.stops.size() != 0) {
-			buses.insert(bus);
+std::vector<uint32_t> RequestHandler::GetAllBuses() const {
+	const CatalogueLayout& layout = db_.GetLayout();
+	std::vector<uint32_t> buses;
+	for (uint32_t bus_id : layout.GetBusesByName()) {
+		if (!layout.GetBusStops(bus_id).empty()) {
+			buses.push_back(bus_id);
 		}
 	}
 	return buses;
 }
 
-const std::set<Stop> RequestHandler::GetAllStops() const {
-	std::set<Stop> stops_with_buses;
-	for (const auto& stop : db_.GetStops()) {
-		if (GetStopInfo(stop.name).value().buses.size() != 0) {
-			stops_with_buses.insert(stop);
+std::vector<uint32_t> RequestHandler::GetAllStops() const {
+	const CatalogueLayout& layout = db_.GetLayout();
+	std::vector<uint32_t> stops_with_buses;
+	for (uint32_t stop_id : layout.GetStopsByName()) {
+		if (!layout.GetStopBuses(stop_id).empty()) {
+			stops_with_buses.push_back(stop_id);
 		}
 	}
 	return stops_with_buses;
 }
+
+const CatalogueLayout& RequestHandler::GetLayout() const {
+	return db_.GetLayout();
+}
@@ -1,5 +1,8 @@
 #pragma once
 #include "transport_catalogue.h"
+#include "versioned_catalogue.h"
+#include <optional>
+#include <vector>
 
 using namespace transport_catalogue;
 
@@ -9,11 +12,23 @@ public:
     : db_(db) {
     };
 
+    // Обработчик закрепляет версию справочника на всё время своей жизни
+    explicit RequestHandler(VersionedCatalogue::Snapshot snapshot)
+    : snapshot_(std::move(snapshot))
+    , db_(**snapshot_) {
+    }
+
     std::optional<statistics::BusInfo> GetBusInfo(std::string_view bus_num) const;
     std::optional<statistics::StopInfo> GetStopInfo(std::string_view stop_name) const;
-    const std::set<Bus> GetAllBuses() const;
-    const std::set<Stop> GetAllStops() const;
+    // Участок маршрута от первого прохода остановки from до ближайшего следующего за ним прохода остановки to;
+    // при from == to это круг до следующего прохода той же остановки
+    std::optional<statistics::BusSegmentInfo> GetBusSegmentInfo(std::string_view bus_num, std::string_view from, std::string_view to) const;
+    // Номера непустых маршрутов и остановок, через которые проходят маршруты, в порядке названий
+    std::vector<uint32_t> GetAllBuses() const;
+    std::vector<uint32_t> GetAllStops() const;
+    const CatalogueLayout& GetLayout() const;
 
 private:
+    std::optional<VersionedCatalogue::Snapshot> snapshot_;
     const TransportCatalogue& db_;
 };
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "road_distance_table.h"
+
+namespace transport_catalogue
+{
+	void RoadDistanceTable::Set(uint32_t from, uint32_t to, int distance) {
+		Slot& slot = InsertSlot(MakeKey(from, to));
+		slot.distance = distance;
+		slot.is_explicit = true;
+
+		Slot& reverse_slot = InsertSlot(MakeKey(to, from));
+		if (!reverse_slot.is_explicit) {
+			reverse_slot.distance = distance;
+		}
+	}
+
+	std::optional<int> RoadDistanceTable::Find(uint32_t from, uint32_t to) const {
+		if (slots_.empty()) {
+			return std::nullopt;
+		}
+		const Slot& slot = slots_[FindSlot(MakeKey(from, to))];
+		if (slot.key == EMPTY_KEY) {
+			return std::nullopt;
+		}
+		return slot.distance;
+	}
+
+	// Возвращает слот с ключом key или пустой слот, в который его можно вставить
+	size_t RoadDistanceTable::FindSlot(uint64_t key) const {
+		const size_t mask = slots_.size() - 1;
+		size_t index = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> shift_);
+		while (slots_[index].key != key && slots_[index].key != EMPTY_KEY) {
+			index = (index + 1) & mask;
+		}
+		return index;
+	}
+
+	RoadDistanceTable::Slot& RoadDistanceTable::InsertSlot(uint64_t key) {
+		// Заполненность не превышает половины, чтобы цепочки проб оставались короткими
+		if ((size_ + 1) * 2 > slots_.size()) {
+			Rehash(slots_.empty() ? MIN_CAPACITY : slots_.size() * 2);
+		}
+		Slot& slot = slots_[FindSlot(key)];
+		if (slot.key == EMPTY_KEY) {
+			slot.key = key;
+			++size_;
+		}
+		return slot;
+	}
+
+	void RoadDistanceTable::Rehash(size_t capacity) {
+		std::vector<Slot> old_slots(capacity);
+		old_slots.swap(slots_);
+		shift_ = 64;
+		for (size_t i = capacity; i > 1; i >>= 1) {
+			--shift_;
+		}
+		for (const Slot& slot : old_slots) {
+			if (slot.key != EMPTY_KEY) {
+				slots_[FindSlot(slot.key)] = slot;
+			}
+		}
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace transport_catalogue
+{
+    // Таблица дорожных расстояний с открытой адресацией. Ключ — пара номеров остановок, упакованная в 64 бита.
+    // Если расстояние в обратную сторону не задано явно, оно записывается вместе с прямым,
+    // поэтому при поиске не нужно второе обращение по обратному ключу.
+    class RoadDistanceTable {
+    public:
+        void Set(uint32_t from, uint32_t to, int distance);
+        std::optional<int> Find(uint32_t from, uint32_t to) const;
+
+        // Вызывает callback(from, to, distance) для каждого явно заданного расстояния
+        template <typename Callback>
+        void ForEachExplicit(Callback callback) const {
+            for (const Slot& slot : slots_) {
+                if (slot.key != EMPTY_KEY && slot.is_explicit) {
+                    callback(static_cast<uint32_t>(slot.key >> 32), static_cast<uint32_t>(slot.key), slot.distance);
+                }
+            }
+        }
+
+    private:
+        static constexpr uint64_t EMPTY_KEY = UINT64_MAX;
+        static constexpr size_t MIN_CAPACITY = 16;
+
+        struct Slot {
+            uint64_t key = EMPTY_KEY;
+            int distance = 0;
+            bool is_explicit = false;
+        };
+
+        static uint64_t MakeKey(uint32_t from, uint32_t to) {
+            return (static_cast<uint64_t>(from) << 32) | to;
+        }
+
+        size_t FindSlot(uint64_t key) const;
+        Slot& InsertSlot(uint64_t key);
+        void Rehash(size_t capacity);
+
+        std::vector<Slot> slots_;
+        size_t size_ = 0;
+        // Номер начального слота — старшие биты произведения ключа на константу Фибоначчи
+        int shift_ = 64;
+    };
+}
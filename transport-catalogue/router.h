@@ -1,14 +1,18 @@
 #pragma once
 
 #include "graph.h"
+#include "thread_pool.h"
 
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <functional>
 #include <iterator>
+#include <limits>
 #include <optional>
+#include <queue>
 #include <stdexcept>
-#include <unordered_map>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -21,6 +25,8 @@ private:
 
 public:
     explicit Router(const Graph& graph);
+    // Блоки матрицы маршрутов обрабатываются задачами пула pool, который используется только в конструкторе
+    Router(const Graph& graph, parallel::ThreadPool& pool);
 
     struct RouteInfo {
         Weight weight;
@@ -29,85 +35,213 @@ public:
 
     std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
 
+    // Восстанавливает маршруты после изменения веса ребра в графе.
+    // Уменьшение веса обрабатывается релаксацией всех пар через ребро за O(V^2),
+    // при увеличении пересчитываются только строки источников, чьи деревья кратчайших путей содержат ребро.
+    void UpdateEdgeWeight(EdgeId edge_id, Weight old_weight);
+
 private:
-    struct RouteInternalData {
-        Weight weight;
-        std::optional<EdgeId> prev_edge;
-    };
-    using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
+    // Матрицы весов и последних рёбер маршрутов хранятся плотно, построчно.
+    // Отсутствие маршрута обозначается весом INFINITE_WEIGHT, отсутствие ребра — NO_EDGE.
+    static constexpr size_t BLOCK_SIZE = 64;
+    static constexpr EdgeId NO_EDGE = std::numeric_limits<EdgeId>::max();
+    static constexpr Weight INFINITE_WEIGHT = std::numeric_limits<Weight>::infinity();
+    static constexpr Weight ZERO_WEIGHT{};
+
+    static_assert(std::numeric_limits<Weight>::has_infinity, "Router requires a weight type with infinity");
 
     void InitializeRoutesInternalData(const Graph& graph) {
         const size_t vertex_count = graph.GetVertexCount();
         for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
-            routes_internal_data_[vertex][vertex] = RouteInternalData{ZERO_WEIGHT, std::nullopt};
+            weights_[vertex * vertex_count + vertex] = ZERO_WEIGHT;
             for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
                 const auto& edge = graph.GetEdge(edge_id);
                 if (edge.weight < ZERO_WEIGHT) {
                     throw std::domain_error("Edges' weights should be non-negative");
                 }
-                auto& route_internal_data = routes_internal_data_[vertex][edge.to];
-                if (!route_internal_data || route_internal_data->weight > edge.weight) {
-                    route_internal_data = RouteInternalData{edge.weight, edge_id};
+                const size_t cell = vertex * vertex_count + edge.to;
+                if (weights_[cell] > edge.weight) {
+                    weights_[cell] = edge.weight;
+                    prev_edges_[cell] = edge_id;
+                }
+            }
+        }
+    }
+
+    // Релаксирует маршруты внутри блока (block_from, block_to) через вершины блока block_through.
+    // Внутренний цикл не содержит ветвлений и векторизуется компилятором.
+    void RelaxBlock(size_t block_from, size_t block_to, size_t block_through) {
+        const size_t n = vertex_count_;
+        const size_t from_end = std::min(n, (block_from + 1) * BLOCK_SIZE);
+        const size_t to_begin = block_to * BLOCK_SIZE;
+        const size_t to_end = std::min(n, to_begin + BLOCK_SIZE);
+        const size_t through_end = std::min(n, (block_through + 1) * BLOCK_SIZE);
+
+        for (VertexId through = block_through * BLOCK_SIZE; through < through_end; ++through) {
+            const Weight* through_weights = weights_.data() + through * n;
+            const EdgeId* through_edges = prev_edges_.data() + through * n;
+            for (VertexId from = block_from * BLOCK_SIZE; from < from_end; ++from) {
+                Weight* from_weights = weights_.data() + from * n;
+                EdgeId* from_edges = prev_edges_.data() + from * n;
+                const Weight weight_from = from_weights[through];
+                if (weight_from == INFINITE_WEIGHT) {
+                    continue;
+                }
+                const EdgeId edge_from = from_edges[through];
+                for (VertexId to = to_begin; to < to_end; ++to) {
+                    const Weight candidate_weight = weight_from + through_weights[to];
+                    const bool is_better = candidate_weight < from_weights[to];
+                    const EdgeId candidate_edge = through_edges[to] != NO_EDGE ? through_edges[to] : edge_from;
+                    from_weights[to] = is_better ? candidate_weight : from_weights[to];
+                    from_edges[to] = is_better ? candidate_edge : from_edges[to];
                 }
             }
         }
     }
 
-    void RelaxRoute(VertexId vertex_from, VertexId vertex_to, const RouteInternalData& route_from,
-                    const RouteInternalData& route_to) {
-        auto& route_relaxing = routes_internal_data_[vertex_from][vertex_to];
-        const Weight candidate_weight = route_from.weight + route_to.weight;
-        if (!route_relaxing || candidate_weight < route_relaxing->weight) {
-            route_relaxing = {candidate_weight,
-                              route_to.prev_edge ? route_to.prev_edge : route_from.prev_edge};
+    // Блочный алгоритм Флойда–Уоршелла: на каждой итерации сначала обрабатывается
+    // диагональный блок, затем параллельно — блоки его строки и столбца, затем параллельно — все остальные.
+    void RelaxRoutesInternalData(parallel::ThreadPool& pool) {
+        const size_t block_count = (vertex_count_ + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+        for (size_t block_through = 0; block_through < block_count; ++block_through) {
+            RelaxBlock(block_through, block_through, block_through);
+
+            pool.ParallelFor(2 * (block_count - 1), [this, block_count, block_through](size_t index) {
+                size_t block = index % (block_count - 1);
+                block += block >= block_through ? 1 : 0;
+                if (index < block_count - 1) {
+                    RelaxBlock(block_through, block, block_through);
+                } else {
+                    RelaxBlock(block, block_through, block_through);
+                }
+            });
+
+            pool.ParallelFor((block_count - 1) * (block_count - 1), [this, block_count, block_through](size_t index) {
+                size_t block_from = index / (block_count - 1);
+                size_t block_to = index % (block_count - 1);
+                block_from += block_from >= block_through ? 1 : 0;
+                block_to += block_to >= block_through ? 1 : 0;
+                RelaxBlock(block_from, block_to, block_through);
+            });
         }
     }
 
-    void RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through) {
-        for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
-            if (const auto& route_from = routes_internal_data_[vertex_from][vertex_through]) {
-                for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
-                    if (const auto& route_to = routes_internal_data_[vertex_through][vertex_to]) {
-                        RelaxRoute(vertex_from, vertex_to, *route_from, *route_to);
-                    }
+    void RelaxRoutesThroughEdge(EdgeId edge_id) {
+        const size_t n = vertex_count_;
+        const auto& edge = graph_.GetEdge(edge_id);
+        const Weight* to_weights = weights_.data() + edge.to * n;
+        const EdgeId* to_edges = prev_edges_.data() + edge.to * n;
+        for (VertexId from = 0; from < n; ++from) {
+            Weight* from_weights = weights_.data() + from * n;
+            EdgeId* from_edges = prev_edges_.data() + from * n;
+            if (from_weights[edge.from] == INFINITE_WEIGHT) {
+                continue;
+            }
+            const Weight weight_from = from_weights[edge.from] + edge.weight;
+            for (VertexId to = 0; to < n; ++to) {
+                const Weight candidate_weight = weight_from + to_weights[to];
+                if (candidate_weight < from_weights[to]) {
+                    from_weights[to] = candidate_weight;
+                    from_edges[to] = to_edges[to] != NO_EDGE ? to_edges[to] : edge_id;
+                }
+            }
+        }
+    }
+
+    // Пересчитывает строку матрицы для одного источника алгоритмом Дейкстры.
+    void RebuildRoutesFrom(VertexId source) {
+        const size_t n = vertex_count_;
+        Weight* weights = weights_.data() + source * n;
+        EdgeId* edges = prev_edges_.data() + source * n;
+        std::fill(weights, weights + n, INFINITE_WEIGHT);
+        std::fill(edges, edges + n, NO_EDGE);
+        weights[source] = ZERO_WEIGHT;
+
+        using QueueItem = std::pair<Weight, VertexId>;
+        std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+        queue.push({ZERO_WEIGHT, source});
+        while (!queue.empty()) {
+            const auto [weight, vertex] = queue.top();
+            queue.pop();
+            if (weight > weights[vertex]) {
+                continue;
+            }
+            for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+                const auto& edge = graph_.GetEdge(edge_id);
+                const Weight candidate_weight = weight + edge.weight;
+                if (candidate_weight < weights[edge.to]) {
+                    weights[edge.to] = candidate_weight;
+                    edges[edge.to] = edge_id;
+                    queue.push({candidate_weight, edge.to});
                 }
             }
         }
     }
 
-    static constexpr Weight ZERO_WEIGHT{};
     const Graph& graph_;
-    RoutesInternalData routes_internal_data_;
+    size_t vertex_count_;
+    std::vector<Weight> weights_;
+    std::vector<EdgeId> prev_edges_;
 };
 
 template <typename Weight>
 Router<Weight>::Router(const Graph& graph)
     : graph_(graph)
-    , routes_internal_data_(graph.GetVertexCount(),
-                            std::vector<std::optional<RouteInternalData>>(graph.GetVertexCount()))
+    , vertex_count_(graph.GetVertexCount())
+    , weights_(vertex_count_ * vertex_count_, INFINITE_WEIGHT)
+    , prev_edges_(vertex_count_ * vertex_count_, NO_EDGE)
+{
+    InitializeRoutesInternalData(graph);
+    // Граф из одного блока обрабатывается без рабочих потоков
+    parallel::ThreadPool pool(vertex_count_ > BLOCK_SIZE ? std::thread::hardware_concurrency() : 1);
+    RelaxRoutesInternalData(pool);
+}
+
+template <typename Weight>
+Router<Weight>::Router(const Graph& graph, parallel::ThreadPool& pool)
+    : graph_(graph)
+    , vertex_count_(graph.GetVertexCount())
+    , weights_(vertex_count_ * vertex_count_, INFINITE_WEIGHT)
+    , prev_edges_(vertex_count_ * vertex_count_, NO_EDGE)
 {
     InitializeRoutesInternalData(graph);
+    RelaxRoutesInternalData(pool);
+}
 
-    const size_t vertex_count = graph.GetVertexCount();
-    for (VertexId vertex_through = 0; vertex_through < vertex_count; ++vertex_through) {
-        RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through);
+template <typename Weight>
+void Router<Weight>::UpdateEdgeWeight(EdgeId edge_id, Weight old_weight) {
+    const auto& edge = graph_.GetEdge(edge_id);
+    if (edge.weight < ZERO_WEIGHT) {
+        throw std::domain_error("Edges' weights should be non-negative");
+    }
+    if (edge.weight < old_weight) {
+        RelaxRoutesThroughEdge(edge_id);
+    } else if (edge.weight > old_weight) {
+        for (VertexId source = 0; source < vertex_count_; ++source) {
+            if (prev_edges_[source * vertex_count_ + edge.to] == edge_id) {
+                RebuildRoutesFrom(source);
+            }
+        }
     }
 }
 
 template <typename Weight>
 std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(VertexId from,
                                                                              VertexId to) const {
-    const auto& route_internal_data = routes_internal_data_.at(from).at(to);
-    if (!route_internal_data) {
+    if (from >= vertex_count_ || to >= vertex_count_) {
+        throw std::out_of_range("Vertex is out of range");
+    }
+    const Weight weight = weights_[from * vertex_count_ + to];
+    if (weight == INFINITE_WEIGHT) {
         return std::nullopt;
     }
-    const Weight weight = route_internal_data->weight;
     std::vector<EdgeId> edges;
-    for (std::optional<EdgeId> edge_id = route_internal_data->prev_edge;
-         edge_id;
-         edge_id = routes_internal_data_[from][graph_.GetEdge(*edge_id).from]->prev_edge)
+    for (EdgeId edge_id = prev_edges_[from * vertex_count_ + to];
+         edge_id != NO_EDGE;
+         edge_id = prev_edges_[from * vertex_count_ + graph_.GetEdge(edge_id).from])
     {
-        edges.push_back(*edge_id);
+        edges.push_back(edge_id);
     }
     std::reverse(edges.begin(), edges.end());
 
@@ -0,0 +1,40 @@
+#include "string_pool.h"
+#include <algorithm>
+#include <string>
+
+namespace transport_catalogue
+{
+	std::string_view StringPool::Intern(std::string_view str) {
+		static const size_t sso_capacity = std::string().capacity();
+		++stats_.intern_calls;
+		stats_.std_string_bytes += sizeof(std::string) + (str.size() > sso_capacity ? str.size() + 1 : 0);
+		if (auto found = strings_.find(str); found != strings_.end()) {
+			return *found;
+		}
+		char* data = Allocate(str.size());
+		std::copy(str.begin(), str.end(), data);
+		std::string_view interned{ data, str.size() };
+		strings_.insert(interned);
+		++stats_.unique_strings;
+		stats_.bytes_used += str.size();
+		return interned;
+	}
+
+	StringPoolStats StringPool::GetStats() const {
+		return stats_;
+	}
+
+	char* StringPool::Allocate(size_t size) {
+		if (size > block_free_) {
+			const size_t block_size = std::max(size, BLOCK_SIZE);
+			blocks_.push_back(std::make_unique<char[]>(block_size));
+			block_pos_ = blocks_.back().get();
+			block_free_ = block_size;
+			stats_.bytes_reserved += block_size;
+		}
+		char* data = block_pos_;
+		block_pos_ += size;
+		block_free_ -= size;
+		return data;
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace transport_catalogue
+{
+    struct StringPoolStats {
+        size_t unique_strings = 0;
+        size_t intern_calls = 0;
+        size_t bytes_used = 0;
+        size_t bytes_reserved = 0;
+        // Сколько памяти заняли бы отдельные std::string на каждый вызов Intern
+        size_t std_string_bytes = 0;
+    };
+
+    // Пул строк: каждая уникальная строка хранится один раз в непрерывных блоках памяти.
+    // Выданные string_view остаются валидными до уничтожения пула, в том числе после его перемещения.
+    class StringPool {
+    public:
+        StringPool() = default;
+        StringPool(const StringPool&) = delete;
+        StringPool& operator=(const StringPool&) = delete;
+        StringPool(StringPool&&) = default;
+        StringPool& operator=(StringPool&&) = default;
+
+        std::string_view Intern(std::string_view str);
+        StringPoolStats GetStats() const;
+
+    private:
+        static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+        char* Allocate(size_t size);
+
+        std::vector<std::unique_ptr<char[]>> blocks_;
+        size_t block_free_ = 0;
+        char* block_pos_ = nullptr;
+        std::unordered_set<std::string_view> strings_;
+        StringPoolStats stats_;
+    };
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+// Пул потоков для параллельного выполнения независимых задач с индексами [0, count).
+// Вызывающий поток тоже выполняет задачи, поэтому пул из thread_count потоков
+// запускает только thread_count - 1 рабочих потоков.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t thread_count = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t GetThreadCount() const;
+
+    // Вызывает func(index) для каждого index из [0, count) и дожидается завершения всех вызовов.
+    // Первое исключение, выброшенное задачей, пробрасывается в вызывающий поток.
+    template <typename Func>
+    void ParallelFor(size_t count, Func func);
+
+private:
+    void WorkerLoop();
+    void RunTasks();
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable task_cv_;
+    std::condition_variable done_cv_;
+    std::function<void(size_t)> task_;
+    size_t task_count_ = 0;
+    std::atomic<size_t> next_index_ = 0;
+    size_t pending_workers_ = 0;
+    size_t generation_ = 0;
+    bool stop_ = false;
+    std::exception_ptr exception_;
+};
+
+inline ThreadPool::ThreadPool(size_t thread_count) {
+    const size_t worker_count = std::max<size_t>(thread_count, 1) - 1;
+    workers_.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i) {
+        workers_.emplace_back([this] {
+            WorkerLoop();
+        });
+    }
+}
+
+inline ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    task_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+inline size_t ThreadPool::GetThreadCount() const {
+    return workers_.size() + 1;
+}
+
+template <typename Func>
+void ThreadPool::ParallelFor(size_t count, Func func) {
+    if (workers_.empty() || count <= 1) {
+        for (size_t index = 0; index < count; ++index) {
+            func(index);
+        }
+        return;
+    }
+    {
+        std::lock_guard lock(mutex_);
+        task_ = std::move(func);
+        task_count_ = count;
+        next_index_ = 0;
+        pending_workers_ = workers_.size();
+        exception_ = nullptr;
+        ++generation_;
+    }
+    task_cv_.notify_all();
+    RunTasks();
+
+    std::unique_lock lock(mutex_);
+    done_cv_.wait(lock, [this] {
+        return pending_workers_ == 0;
+    });
+    task_ = nullptr;
+    if (exception_) {
+        std::rethrow_exception(exception_);
+    }
+}
+
+inline void ThreadPool::WorkerLoop() {
+    size_t seen_generation = 0;
+    while (true) {
+        {
+            std::unique_lock lock(mutex_);
+            task_cv_.wait(lock, [this, seen_generation] {
+                return stop_ || generation_ != seen_generation;
+            });
+            if (stop_) {
+                return;
+            }
+            seen_generation = generation_;
+        }
+        RunTasks();
+        {
+            std::lock_guard lock(mutex_);
+            if (--pending_workers_ == 0) {
+                done_cv_.notify_one();
+            }
+        }
+    }
+}
+
+inline void ThreadPool::RunTasks() {
+    for (size_t index = next_index_++; index < task_count_; index = next_index_++) {
+        try {
+            task_(index);
+        } catch (...) {
+            std::lock_guard lock(mutex_);
+            if (!exception_) {
+                exception_ = std::current_exception();
+            }
+        }
+    }
+}
+
+}  // namespace parallel
@@ -0,0 +1,134 @@
+#include "transfer_index.h"
+#include "bits.h"
+#include <algorithm>
+
+namespace transport_catalogue
+{
+	TransferIndex::TransferIndex(const TransportCatalogue& catalogue)
+		: catalogue_(catalogue) {
+		const CatalogueLayout& layout = catalogue.GetLayout();
+		sorted_stop_names_.reserve(layout.GetStopCount());
+		for (uint32_t stop_id = 0; stop_id < layout.GetStopCount(); ++stop_id) {
+			sorted_stop_names_.push_back(layout.GetStopName(stop_id));
+		}
+		sorted_bus_names_.reserve(layout.GetBusCount());
+		for (uint32_t bus_id = 0; bus_id < layout.GetBusCount(); ++bus_id) {
+			sorted_bus_names_.push_back(layout.GetBusName(bus_id));
+		}
+		std::sort(sorted_stop_names_.begin(), sorted_stop_names_.end());
+		std::sort(sorted_bus_names_.begin(), sorted_bus_names_.end());
+		auto rank_of = [](const std::vector<std::string_view>& sorted_names, std::string_view name) {
+			return static_cast<uint32_t>(std::lower_bound(sorted_names.begin(), sorted_names.end(), name) - sorted_names.begin());
+		};
+
+		stop_buses_.offsets.reserve(layout.GetStopCount() + 1);
+		stop_buses_.offsets.push_back(0);
+		for (uint32_t stop_id = 0; stop_id < layout.GetStopCount(); ++stop_id) {
+			const size_t row_begin = stop_buses_.ranks.size();
+			for (uint32_t bus_id : layout.GetStopBuses(stop_id)) {
+				stop_buses_.ranks.push_back(rank_of(sorted_bus_names_, layout.GetBusName(bus_id)));
+			}
+			std::sort(stop_buses_.ranks.begin() + row_begin, stop_buses_.ranks.end());
+			stop_buses_.offsets.push_back(static_cast<uint32_t>(stop_buses_.ranks.size()));
+		}
+
+		bus_stops_.offsets.reserve(layout.GetBusCount() + 1);
+		bus_stops_.offsets.push_back(0);
+		for (uint32_t bus_id = 0; bus_id < layout.GetBusCount(); ++bus_id) {
+			const size_t row_begin = bus_stops_.ranks.size();
+			for (uint32_t stop_id : layout.GetBusStops(bus_id)) {
+				bus_stops_.ranks.push_back(rank_of(sorted_stop_names_, layout.GetStopName(stop_id)));
+			}
+			std::sort(bus_stops_.ranks.begin() + row_begin, bus_stops_.ranks.end());
+			bus_stops_.ranks.erase(std::unique(bus_stops_.ranks.begin() + row_begin, bus_stops_.ranks.end()), bus_stops_.ranks.end());
+			bus_stops_.offsets.push_back(static_cast<uint32_t>(bus_stops_.ranks.size()));
+		}
+
+		BuildBitsets(stop_buses_, sorted_bus_names_.size());
+		BuildBitsets(bus_stops_, sorted_stop_names_.size());
+	}
+
+	void TransferIndex::BuildBitsets(Rows& rows, size_t universe) {
+		rows.words_per_row = (universe + 63) / 64;
+		const size_t row_count = rows.offsets.size() - 1;
+		rows.bitsets.assign(row_count, NO_BITSET);
+		for (size_t row = 0; row < row_count; ++row) {
+			const size_t length = rows.offsets[row + 1] - rows.offsets[row];
+			// Множество из universe бит не больше списка из length 32-битных позиций
+			if (length == 0 || length * 32 < universe) {
+				continue;
+			}
+			rows.bitsets[row] = static_cast<uint32_t>(rows.words.size());
+			rows.words.resize(rows.words.size() + rows.words_per_row);
+			uint64_t* words = rows.words.data() + rows.bitsets[row];
+			for (uint32_t i = rows.offsets[row]; i < rows.offsets[row + 1]; ++i) {
+				words[rows.ranks[i] / 64] |= uint64_t{1} << (rows.ranks[i] % 64);
+			}
+		}
+	}
+
+	std::vector<std::string_view> TransferIndex::IntersectRows(const Rows& rows, uint32_t first, uint32_t second,
+		const std::vector<std::string_view>& sorted_names) {
+		std::vector<std::string_view> names;
+		const uint32_t first_bitset = rows.bitsets[first];
+		const uint32_t second_bitset = rows.bitsets[second];
+		if (first_bitset != NO_BITSET && second_bitset != NO_BITSET) {
+			const uint64_t* lhs = rows.words.data() + first_bitset;
+			const uint64_t* rhs = rows.words.data() + second_bitset;
+			for (size_t word = 0; word < rows.words_per_row; ++word) {
+				for (uint64_t common = lhs[word] & rhs[word]; common != 0; common &= common - 1) {
+					names.push_back(sorted_names[word * 64 + bits::CountTrailingZeros(common)]);
+				}
+			}
+			return names;
+		}
+		if (first_bitset != NO_BITSET || second_bitset != NO_BITSET) {
+			// Позиции разреженной строки проверяются по битам плотной
+			const uint64_t* dense = rows.words.data() + (first_bitset != NO_BITSET ? first_bitset : second_bitset);
+			const uint32_t sparse = first_bitset != NO_BITSET ? second : first;
+			for (uint32_t i = rows.offsets[sparse]; i < rows.offsets[sparse + 1]; ++i) {
+				const uint32_t rank = rows.ranks[i];
+				if ((dense[rank / 64] >> (rank % 64)) & 1) {
+					names.push_back(sorted_names[rank]);
+				}
+			}
+			return names;
+		}
+		const uint32_t* lhs = rows.ranks.data() + rows.offsets[first];
+		const uint32_t* lhs_end = rows.ranks.data() + rows.offsets[first + 1];
+		const uint32_t* rhs = rows.ranks.data() + rows.offsets[second];
+		const uint32_t* rhs_end = rows.ranks.data() + rows.offsets[second + 1];
+		while (lhs != lhs_end && rhs != rhs_end) {
+			if (*lhs < *rhs) {
+				++lhs;
+			}
+			else if (*rhs < *lhs) {
+				++rhs;
+			}
+			else {
+				names.push_back(sorted_names[*lhs]);
+				++lhs;
+				++rhs;
+			}
+		}
+		return names;
+	}
+
+	std::optional<std::vector<std::string_view>> TransferIndex::GetCommonBuses(std::string_view first_stop, std::string_view second_stop) const {
+		const Stop* first = catalogue_.GetStop(first_stop);
+		const Stop* second = catalogue_.GetStop(second_stop);
+		if (!first || !second) {
+			return std::nullopt;
+		}
+		return IntersectRows(stop_buses_, first->id, second->id, sorted_bus_names_);
+	}
+
+	std::optional<std::vector<std::string_view>> TransferIndex::GetTransferStops(std::string_view first_bus, std::string_view second_bus) const {
+		const Bus* first = catalogue_.GetBus(first_bus);
+		const Bus* second = catalogue_.GetBus(second_bus);
+		if (!first || !second) {
+			return std::nullopt;
+		}
+		return IntersectRows(bus_stops_, first->id, second->id, sorted_stop_names_);
+	}
+}
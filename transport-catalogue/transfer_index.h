@@ -0,0 +1,54 @@
+#pragma once
+#include "transport_catalogue.h"
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace transport_catalogue
+{
+    // Инцидентность «остановка — маршрут» для запросов о пересадках.
+    // Для каждой остановки хранятся позиции её маршрутов в порядке названий, для каждого маршрута — позиции его
+    // остановок без повторов. Все строки хранятся отсортированными списками, а строки, которые заполнены хотя бы
+    // на 1/32, ещё и битовыми множествами: такое множество не больше списка. Пересечение двух плотных строк —
+    // поразрядное И по 64 бита за раз, плотной и разреженной — проверка битов по списку, двух разреженных — слияние.
+    // Результат в любом случае получается в порядке названий. Память пропорциональна числу пар «остановка — маршрут».
+    // Индекс строится по текущему состоянию справочника и не отслеживает его изменения.
+    class TransferIndex {
+    public:
+        explicit TransferIndex(const TransportCatalogue& catalogue);
+
+        // Маршруты, проходящие через обе остановки, в порядке названий
+        std::optional<std::vector<std::string_view>> GetCommonBuses(std::string_view first_stop, std::string_view second_stop) const;
+        // Остановки, через которые проходят оба маршрута, в порядке названий
+        std::optional<std::vector<std::string_view>> GetTransferStops(std::string_view first_bus, std::string_view second_bus) const;
+
+    private:
+        static constexpr uint32_t NO_BITSET = UINT32_MAX;
+
+        // Строки списков хранятся подряд: строка i занимает [offsets[i], offsets[i + 1]).
+        // Битовое множество плотной строки i занимает words_per_row слов с позиции bitsets[i], у разреженной bitsets[i] == NO_BITSET
+        struct Rows {
+            std::vector<uint32_t> offsets;
+            std::vector<uint32_t> ranks;
+            std::vector<uint32_t> bitsets;
+            std::vector<uint64_t> words;
+            size_t words_per_row = 0;
+        };
+
+        // Заполняет битовые множества строк, позиции в которых меньше universe
+        static void BuildBitsets(Rows& rows, size_t universe);
+
+        // Названия, позиции которых есть в обеих строках, в порядке позиций
+        static std::vector<std::string_view> IntersectRows(const Rows& rows, uint32_t first, uint32_t second,
+            const std::vector<std::string_view>& sorted_names);
+
+        const TransportCatalogue& catalogue_;
+        // Названия остановок и маршрутов по порядку
+        std::vector<std::string_view> sorted_stop_names_;
+        std::vector<std::string_view> sorted_bus_names_;
+        // Строки по номеру в справочнике: маршруты каждой остановки и остановки каждого маршрута
+        Rows stop_buses_;
+        Rows bus_stops_;
+    };
+}
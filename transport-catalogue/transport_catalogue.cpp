@@ -1,37 +1,176 @@
 #include "transport_catalogue.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
 #include <unordered_set>
 
 namespace  transport_catalogue
 {	
-	void TransportCatalogue::AddStop(const std::string& name, double latitude, double longitude)
+	TransportCatalogue::TransportCatalogue(const TransportCatalogue& other) {
+		CopyFrom(other, nullptr, nullptr);
+		if (other.layout_) {
+			Finalize();
+		}
+	}
+
+	TransportCatalogue& TransportCatalogue::operator=(const TransportCatalogue& other) {
+		if (this != &other) {
+			TransportCatalogue copy(other);
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+
+	// Указатели и string_view в индексах ссылаются на собственные данные справочника,
+	// поэтому копия строится повторным добавлением остановок, расстояний и маршрутов
+	void TransportCatalogue::CopyFrom(const TransportCatalogue& other, const Stop* skipped_stop, const Bus* skipped_bus) {
+		for (const auto& stop : other.stops_) {
+			if (&stop != skipped_stop) {
+				AddStop(stop.name, stop.coordinates.lat, stop.coordinates.lng);
+			}
+		}
+		other.road_distances_.ForEachExplicit([this, &other, skipped_stop](uint32_t from_id, uint32_t to_id, int distance) {
+			const Stop& from = other.stops_[from_id];
+			const Stop& to = other.stops_[to_id];
+			if (&from != skipped_stop && &to != skipped_stop) {
+				AddDistanceBetweenStops(GetStop(from.name), GetStop(to.name), distance);
+			}
+		});
+		for (const auto& bus : other.buses_) {
+			if (&bus == skipped_bus) {
+				continue;
+			}
+			std::vector<Stop*> stops;
+			stops.reserve(bus.stops.size());
+			for (const auto& stop : bus.stops) {
+				stops.push_back(GetStop(stop->name));
+			}
+			AddBus(bus.bus_num, stops, bus.is_roundtrip);
+		}
+	}
+
+	Stop* TransportCatalogue::AddStop(std::string_view name, double latitude, double longitude)
 	{
-		Stop new_stop = Stop{ name, {latitude, longitude } };
-		stops_.push_back(std::move(new_stop));
-		stopname_to_stop_[stops_.back().name] = &stops_.back();
+		Stop new_stop = Stop{ names_.Intern(name), {latitude, longitude }, static_cast<uint32_t>(stops_.size()) };
+		Stop& added_stop = stops_.emplace_back(std::move(new_stop));
+		layout_.reset();
+		stopname_to_stop_[added_stop.name] = &added_stop;
+		stop_buses_.emplace_back();
+		return &added_stop;
 	}
 
-	void TransportCatalogue::AddBus(const std::string& bus_num, const std::vector<Stop*>& stops, bool is_round)
+	void TransportCatalogue::AddBus(std::string_view bus_num, const std::vector<Stop*>& stops, bool is_round)
 	{
-		Bus new_bus = Bus{ bus_num, stops, is_round };
+		Bus new_bus = Bus{ names_.Intern(bus_num), stops, is_round, static_cast<uint32_t>(buses_.size()) };
 		Bus& added_bus = buses_.emplace_back(std::move(new_bus));
+		layout_.reset();
 
+		// Через остановку проходит немного маршрутов, поэтому вставка с сохранением порядка названий дешевле дерева
 		for (const auto& stop : stops) {
-			stop_buses_[stop].insert(added_bus.bus_num);
+			std::vector<Bus*>& stop_buses = stop_buses_[stop->id];
+			auto position = std::lower_bound(stop_buses.begin(), stop_buses.end(), added_bus.bus_num, [](const Bus* bus, std::string_view bus_num) {
+				return bus->bus_num < bus_num;
+			});
+			if (position == stop_buses.end() || (*position)->bus_num != added_bus.bus_num) {
+				stop_buses.insert(position, &added_bus);
+			}
 		}
 
 		busname_to_bus_[added_bus.bus_num] = &added_bus;
+		ComputeDistancePrefixes(added_bus);
+	}	
 
-		for (size_t i = 0; i != added_bus.stops.size() - 1; ++i) {
-			auto stops_pair = std::make_pair(added_bus.stops[i], added_bus.stops[i + 1]);
-			geographical_distance_[stops_pair] = ComputeDistance(stops_pair.first->coordinates, stops_pair.second->coordinates);
+	void TransportCatalogue::ComputeDistancePrefixes(Bus& bus) const {
+		bus.road_distance_prefix.assign(bus.stops.empty() ? 0 : 1, 0);
+		bus.geo_distance_prefix.assign(bus.stops.empty() ? 0 : 1, 0.0);
+		bool has_road_distances = true;
+		for (size_t i = 1; i < bus.stops.size(); ++i) {
+			bus.geo_distance_prefix.push_back(bus.geo_distance_prefix.back()
+				+ ComputeDistance(bus.stops[i - 1]->coordinates, bus.stops[i]->coordinates));
+			if (auto distance = road_distances_.Find(bus.stops[i - 1]->id, bus.stops[i]->id); distance && has_road_distances) {
+				bus.road_distance_prefix.push_back(bus.road_distance_prefix.back() + *distance);
+			}
+			else {
+				has_road_distances = false;
+			}
 		}
-	}	
+		if (!has_road_distances) {
+			bus.road_distance_prefix.clear();
+		}
+	}
 
 	void TransportCatalogue::AddDistanceBetweenStops(Stop* stop, Stop* other_stop, int distance) {
-		road_distance_[{stop, other_stop}] = distance;
+		road_distances_.Set(stop->id, other_stop->id, distance);
+		// Перегон в любом направлении проходит через stop, поэтому пересчитываются только его маршруты
+		UpdateStopBuses(stop);
+	}
+
+	void TransportCatalogue::UpdateStopBuses(const Stop* stop) {
+		for (Bus* bus : GetStopBuses(stop)) {
+			ComputeDistancePrefixes(*bus);
+			if (!layout_) {
+				continue;
+			}
+			// Отрезок маршрута в общих массивах не меняет длину, поэтому расстояния переписываются на месте
+			const size_t offset = layout_->bus_stop_offsets_[bus->id];
+			layout_->bus_has_road_distances_[bus->id] = !bus->road_distance_prefix.empty();
+			std::copy(bus->road_distance_prefix.begin(), bus->road_distance_prefix.end(), layout_->road_distance_prefix_.begin() + offset);
+			std::copy(bus->geo_distance_prefix.begin(), bus->geo_distance_prefix.end(), layout_->geo_distance_prefix_.begin() + offset);
+		}
+		// Рейтинги перестраиваются в Finalize(), а не после каждого изменения
+		if (layout_) {
+			layout_->MarkRankingStale(RankingMetric::ROUTE_LENGTH);
+			layout_->MarkRankingStale(RankingMetric::CURVATURE);
+		}
+	}
+
+	void TransportCatalogue::SetStopCoordinates(std::string_view stop_name, double latitude, double longitude) {
+		using namespace std::literals;
+		Stop* stop = GetStop(stop_name);
+		if (!stop) {
+			throw std::invalid_argument("Unknown stop"s);
+		}
+		stop->coordinates = { latitude, longitude };
+		if (layout_) {
+			layout_->SetStopCoordinates(stop->id, stop->coordinates);
+		}
+		UpdateStopBuses(stop);
+	}
+
+	bool TransportCatalogue::RemoveBus(std::string_view bus_num) {
+		Bus* bus = GetBus(bus_num);
+		if (!bus) {
+			return false;
+		}
+		TransportCatalogue rebuilt;
+		rebuilt.CopyFrom(*this, nullptr, bus);
+		*this = std::move(rebuilt);
+		return true;
+	}
+
+	bool TransportCatalogue::RemoveStop(std::string_view stop_name) {
+		using namespace std::literals;
+		Stop* stop = GetStop(stop_name);
+		if (!stop) {
+			return false;
+		}
+		if (!GetStopBuses(stop).empty()) {
+			throw std::logic_error("Stop is used by buses"s);
+		}
+		TransportCatalogue rebuilt;
+		rebuilt.CopyFrom(*this, stop, nullptr);
+		*this = std::move(rebuilt);
+		return true;
 	}
 
 	Stop* TransportCatalogue::GetStop(std::string_view stop_name) const {
+		if (layout_) {
+			if (stops_by_slot_.empty()) {
+				return nullptr;
+			}
+			Stop* stop = stops_by_slot_[stop_name_hash_.GetSlot(stop_name)];
+			return stop->name == stop_name ? stop : nullptr;
+		}
 		if (auto founded_stop = stopname_to_stop_.find(stop_name); founded_stop != stopname_to_stop_.end()) {
 			return founded_stop->second;
 		}
@@ -39,19 +178,22 @@ namespace  transport_catalogue
 	}
 
 	Bus* TransportCatalogue::GetBus(std::string_view bus_num) const {
+		if (layout_) {
+			if (buses_by_slot_.empty()) {
+				return nullptr;
+			}
+			Bus* bus = buses_by_slot_[bus_name_hash_.GetSlot(bus_num)];
+			return bus->bus_num == bus_num ? bus : nullptr;
+		}
 		if (auto founded_bus = busname_to_bus_.find(bus_num); founded_bus != busname_to_bus_.end()) {
 			return founded_bus->second;
 		}
 		return nullptr;
 	}
 
-	const std::set<std::string_view>* TransportCatalogue::GetStopBuses(Stop* stop) const
+	const std::vector<Bus*>& TransportCatalogue::GetStopBuses(const Stop* stop) const
 	{
-		if (stop_buses_.count(stop) != 0) {
-			const std::set<std::string_view>* stop_buses = &stop_buses_.at(stop);
-			return stop_buses;
-		}
-		return nullptr;
+		return stop_buses_[stop->id];
 	}
 
 	const std::deque<Bus>& TransportCatalogue::GetBuses() const {
@@ -80,31 +222,123 @@ namespace  transport_catalogue
 	}
 
 	int TransportCatalogue::CountDistanceBetweenStops( Stop* from, Stop* to) const {
-		int distance = 0;
-		if (road_distance_.count({ from, to }) == 0) {
-			distance += road_distance_.at({ to, from });
-		}
-		else {
-			distance += road_distance_.at({ from, to });
+		return CountDistanceBetweenStops(from->id, to->id);
+	}
+
+	int TransportCatalogue::CountDistanceBetweenStops(uint32_t from_id, uint32_t to_id) const {
+		using namespace std::literals;
+		if (auto distance = road_distances_.Find(from_id, to_id)) {
+			return *distance;
 		}
-		return distance;
+		throw std::out_of_range("Road distance is not set"s);
 	}
 
 	int TransportCatalogue::CountRouteDistance(const Bus& bus) const {
-		int route_distance = 0;
-		for (size_t i = 0; i != bus.stops.size() - 1; ++i) {
-			route_distance += CountDistanceBetweenStops(bus.stops[i], bus.stops[i+1]);
-		}
+		return CountSegmentDistance(bus, 0, bus.stops.size() - 1);
+	}
 
-		return route_distance;
+	int TransportCatalogue::CountSegmentDistance(const Bus& bus, size_t from_index, size_t to_index) const {
+		using namespace std::literals;
+		if (bus.road_distance_prefix.empty()) {
+			throw std::out_of_range("Road distance is not set"s);
+		}
+		return bus.road_distance_prefix.at(to_index) - bus.road_distance_prefix.at(from_index);
 	}
 
 	double TransportCatalogue::CountRouteCurvature(const Bus& bus, int real_distance) const {
-		double curvature = 0.0;
-		for (size_t i = 0; i != bus.stops.size() - 1; ++i) {
-			curvature += geographical_distance_.at({ bus.stops[i], bus.stops[i + 1] });
+		return real_distance / bus.geo_distance_prefix.back();
+	}
+
+	StringPoolStats TransportCatalogue::GetNamePoolStats() const {
+		return names_.GetStats();
+	}
+
+	void TransportCatalogue::Finalize() {
+		if (layout_) {
+			layout_->BuildStaleRankings();
+			return;
+		}
+		BuildNameIndex(stopname_to_stop_, stop_name_hash_, stops_by_slot_);
+		BuildNameIndex(busname_to_bus_, bus_name_hash_, buses_by_slot_);
+		CatalogueLayout& layout = layout_.emplace();
+
+		layout.stop_names_.reserve(stops_.size());
+		layout.stop_bus_offsets_.reserve(stops_.size() + 1);
+		layout.stop_bus_offsets_.push_back(0);
+		for (const Stop& stop : stops_) {
+			layout.stop_names_.push_back(stop.name);
+			layout.AddStopCoordinates(stop.coordinates);
+			for (const Bus* bus : stop_buses_[stop.id]) {
+				layout.stop_bus_ids_.push_back(bus->id);
+				layout.stop_bus_names_.push_back(bus->bus_num);
+			}
+			layout.stop_bus_offsets_.push_back(static_cast<uint32_t>(layout.stop_bus_ids_.size()));
+		}
+
+		layout.bus_names_.reserve(buses_.size());
+		layout.bus_is_roundtrip_.reserve(buses_.size());
+		layout.bus_has_road_distances_.reserve(buses_.size());
+		layout.unique_stop_counts_.reserve(buses_.size());
+		layout.bus_stop_offsets_.reserve(buses_.size() + 1);
+		layout.bus_stop_offsets_.push_back(0);
+		for (const Bus& bus : buses_) {
+			layout.bus_names_.push_back(bus.bus_num);
+			layout.bus_is_roundtrip_.push_back(bus.is_roundtrip);
+			layout.bus_has_road_distances_.push_back(!bus.road_distance_prefix.empty());
+			layout.unique_stop_counts_.push_back(GetUniqueStops(bus));
+			for (const Stop* stop : bus.stops) {
+				layout.route_stop_ids_.push_back(stop->id);
+			}
+			if (bus.road_distance_prefix.empty()) {
+				layout.road_distance_prefix_.resize(layout.route_stop_ids_.size(), 0);
+			}
+			else {
+				layout.road_distance_prefix_.insert(layout.road_distance_prefix_.end(), bus.road_distance_prefix.begin(), bus.road_distance_prefix.end());
+			}
+			layout.geo_distance_prefix_.insert(layout.geo_distance_prefix_.end(), bus.geo_distance_prefix.begin(), bus.geo_distance_prefix.end());
+			layout.bus_stop_offsets_.push_back(static_cast<uint32_t>(layout.route_stop_ids_.size()));
+		}
+
+		layout.stops_by_name_.resize(stops_.size());
+		std::iota(layout.stops_by_name_.begin(), layout.stops_by_name_.end(), 0);
+		std::sort(layout.stops_by_name_.begin(), layout.stops_by_name_.end(), [this](uint32_t lhs, uint32_t rhs) {
+			return stops_[lhs] < stops_[rhs];
+		});
+		layout.buses_by_name_.resize(buses_.size());
+		std::iota(layout.buses_by_name_.begin(), layout.buses_by_name_.end(), 0);
+		std::sort(layout.buses_by_name_.begin(), layout.buses_by_name_.end(), [this](uint32_t lhs, uint32_t rhs) {
+			return buses_[lhs] < buses_[rhs];
+		});
+		layout.BuildRankings();
+	}
+
+	template <typename Object>
+	void TransportCatalogue::BuildNameIndex(const std::unordered_map<std::string_view, Object*>& name_to_object, PerfectHash& hash, std::vector<Object*>& objects_by_slot) {
+		std::vector<std::string_view> names;
+		std::vector<Object*> objects;
+		names.reserve(name_to_object.size());
+		objects.reserve(name_to_object.size());
+		for (const auto& [name, object] : name_to_object) {
+			names.push_back(name);
+			objects.push_back(object);
+		}
+		const std::vector<uint32_t> slots = hash.Build(names);
+		objects_by_slot.assign(objects.size(), nullptr);
+		for (size_t i = 0; i < objects.size(); ++i) {
+			objects_by_slot[slots[i]] = objects[i];
+		}
+	}
+
+	bool TransportCatalogue::IsFinalized() const {
+		return layout_.has_value();
+	}
+
+	const CatalogueLayout& TransportCatalogue::GetLayout() const {
+		using namespace std::literals;
+		if (!layout_) {
+			throw std::logic_error("Catalogue is not finalized"s);
 		}
-		return real_distance / curvature;
+		return *layout_;
 	}
 
-}
\ No newline at end of file
+}
@@ -1,9 +1,14 @@
 #pragma once
+#include "catalogue_layout.h"
 #include "domain.h"
 #include "geo.h"
+#include "perfect_hash.h"
+#include "road_distance_table.h"
+#include "string_pool.h"
 #include <deque>
 #include <optional>
 #include <set>
+#include <vector>
 #include <unordered_map>
 
 namespace statistics {
@@ -17,7 +22,13 @@ namespace statistics {
 
     struct StopInfo {
         std::string_view stop_name;
-        std::set<std::string_view> buses;
+        // Названия маршрутов через остановку в порядке названий; указывает на представление справочника
+        transport_catalogue::CatalogueLayout::NameRange buses;
+    };
+
+    struct BusSegmentInfo {
+        int distance;
+        int span_count;
     };
 }
 
@@ -25,22 +36,26 @@ namespace  transport_catalogue
 {
     using namespace domain;
 
-    struct DistanceHasher {
-        size_t operator()(const std::pair< Stop*, Stop*> stop_pair) const {
-            std::hash<std::string> hasher;
-            return hasher(stop_pair.first->name) + hasher(stop_pair.second->name) * 31;
-        }
-    };
-
     class TransportCatalogue {
     public:
         TransportCatalogue() = default;
-        void AddStop(const std::string& name, double latitude, double longitude);
-        void AddBus(const std::string& bus_num, const std::vector<Stop*>& stops, bool is_round);
+        TransportCatalogue(const TransportCatalogue& other);
+        TransportCatalogue(TransportCatalogue&& other) = default;
+        TransportCatalogue& operator=(const TransportCatalogue& other);
+        TransportCatalogue& operator=(TransportCatalogue&& other) = default;
+
+        // Добавление и удаление остановок и маршрутов сбрасывает представление для запросов,
+        // после них нужно снова вызвать Finalize(). Изменение координат и расстояний обновляет его на месте.
+        Stop* AddStop(std::string_view name, double latitude, double longitude);
+        void AddBus(std::string_view bus_num, const std::vector<Stop*>& stops, bool is_round);
         void AddDistanceBetweenStops(Stop* stop, Stop* other_stop, int distance);
+        void SetStopCoordinates(std::string_view stop_name, double latitude, double longitude);
+        bool RemoveBus(std::string_view bus_num);
+        bool RemoveStop(std::string_view stop_name);
         Stop* GetStop(std::string_view stop_name) const;
         Bus* GetBus(std::string_view bus_num) const;
-        const std::set<std::string_view>* GetStopBuses(Stop* stop) const;
+        // Маршруты через остановку в порядке названий
+        const std::vector<Bus*>& GetStopBuses(const Stop* stop) const;
         const std::deque<Bus>& GetBuses() const;
         const std::deque<Stop>& GetStops() const;
         std::deque<const Stop*> GetStopsPointers() const;
@@ -48,18 +63,43 @@ namespace  transport_catalogue
         int GetUniqueStops(const Bus& bus) const;
         int GetStops(const Bus& bus) const;
         int CountDistanceBetweenStops( Stop* from,  Stop* to) const;
+        int CountDistanceBetweenStops(uint32_t from_id, uint32_t to_id) const;
         int CountRouteDistance(const Bus& bus) const;
+        // Дорожное расстояние между остановками маршрута с индексами from_index <= to_index
+        int CountSegmentDistance(const Bus& bus, size_t from_index, size_t to_index) const;
         double CountRouteCurvature(const Bus& bus, int real_distance) const;
+        StringPoolStats GetNamePoolStats() const;
+
+        // Строит представление справочника для запросов и таблицы поиска по имени, если они ещё не построены,
+        // иначе перестраивает рейтинги, устаревшие после изменения расстояний и координат
+        void Finalize();
+        bool IsFinalized() const;
+        const CatalogueLayout& GetLayout() const;
 
     private:
-        std::unordered_map<Stop*, std::set<std::string_view>> stop_buses_;
-        std::unordered_map<std::pair<Stop*, Stop*>, double, DistanceHasher> geographical_distance_;
-        std::unordered_map<std::pair<Stop*, Stop*>, int, DistanceHasher> road_distance_;
+        // Имена остановок и маршрутов, на которые ссылаются Stop::name, Bus::bus_num и индексы
+        StringPool names_;
+
+        void CopyFrom(const TransportCatalogue& other, const Stop* skipped_stop, const Bus* skipped_bus);
+        void ComputeDistancePrefixes(Bus& bus) const;
+        // Пересчитывает расстояния маршрутов остановки: в самих маршрутах и в представлении для запросов
+        void UpdateStopBuses(const Stop* stop);
+        template <typename Object>
+        static void BuildNameIndex(const std::unordered_map<std::string_view, Object*>& name_to_object, PerfectHash& hash, std::vector<Object*>& objects_by_slot);
+
+        // Маршруты через остановку, по вектору на номер остановки
+        std::vector<std::vector<Bus*>> stop_buses_;
+        RoadDistanceTable road_distances_;
         std::unordered_map<std::string_view, Bus*> busname_to_bus_;
         std::unordered_map<std::string_view, Stop*> stopname_to_stop_;
         std::deque<Bus> buses_;
         std::deque<Stop> stops_;
-
+        std::optional<CatalogueLayout> layout_;
+        // Поиск по имени в подготовленном справочнике: совершенный хеш и объекты по его позициям
+        PerfectHash stop_name_hash_;
+        std::vector<Stop*> stops_by_slot_;
+        PerfectHash bus_name_hash_;
+        std::vector<Bus*> buses_by_slot_;
 
     };
 };
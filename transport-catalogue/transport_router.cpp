@@ -1,59 +1,300 @@
 #include "transport_router.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <thread>
 
 TransportRouter& TransportRouter::SetBusWaitTime(int time) {
 	properties_.bus_wait_time = time;
+	if (graph_) {
+		// Меняется вес всех рёбер ожидания, поэтому маршрутизатор перестраивается при следующем запросе
+		router_.reset();
+		for (graph::EdgeId edge_id = 0; edge_id < edge_kinds_.size(); ++edge_id) {
+			if (edge_kinds_[edge_id] == EdgeKind::WAIT) {
+				graph_->SetEdgeWeight(edge_id, time * 1.0);
+			}
+		}
+	}
 	return *this;
 }
 
 TransportRouter& TransportRouter::SetBusVelocity(double velocity) {
 	properties_.bus_velocity = velocity;
+	if (graph_) {
+		// Время всех поездок меняется в одно и то же число раз, поэтому выбранные поездки рёбер остаются прежними
+		router_.reset();
+		for (graph::EdgeId edge_id = 0; edge_id < edge_kinds_.size(); ++edge_id) {
+			if (edge_kinds_[edge_id] == EdgeKind::BUS) {
+				graph_->SetEdgeWeight(edge_id, ComputeRideTime(ride_distances_[edge_owners_[edge_id]]));
+			}
+		}
+	}
+	return *this;
+}
+
+TransportRouter& TransportRouter::UpdateRoadDistance(std::string_view from, std::string_view to, int distance) {
+	using namespace std::literals;
+	if (!mutable_catalogue_) {
+		throw std::logic_error("Catalogue snapshot is read-only"s);
+	}
+	Stop* stop_from = catalogue_.GetStop(from);
+	Stop* stop_to = catalogue_.GetStop(to);
+	if (!stop_from || !stop_to) {
+		throw std::invalid_argument("Unknown stop"s);
+	}
+	mutable_catalogue_->AddDistanceBetweenStops(stop_from, stop_to, distance);
+	mutable_catalogue_->Finalize();
+	if (!graph_) {
+		return *this;
+	}
+
+	const CatalogueLayout& layout = catalogue_.GetLayout();
+	for (uint32_t bus_id : layout.GetStopBuses(stop_from->id)) {
+		const CatalogueLayout::IdRange stops = layout.GetBusStops(bus_id);
+		for (auto it = stops.begin(); it + 1 < stops.end(); ++it) {
+			if ((it[0] == stop_from->id && it[1] == stop_to->id)
+				|| (it[0] == stop_to->id && it[1] == stop_from->id)) {
+				UpdateBusEdges(bus_id);
+				break;
+			}
+		}
+	}
 	return *this;
 }
 
+parallel::ThreadPool& TransportRouter::GetThreadPool() {
+	if (!thread_pool_) {
+		thread_pool_ = std::make_unique<parallel::ThreadPool>(std::thread::hardware_concurrency());
+	}
+	return *thread_pool_;
+}
+
 void TransportRouter::MakeGraph() {
 	if (graph_) {
 		return;
 	}
-	size_t i = 0;
-	const auto stops = catalogue_.GetStopsPointers();
-	graph_ = std::make_unique<graph::DirectedWeightedGraph<double>>(stops.size() * 2);
-	for (const auto& stop : stops) {
-		graph::Edge<double> edge = {i++, i++, properties_.bus_wait_time * 1.0};
-		graph::EdgeId edge_id = graph_->AddEdge(edge);
-		stops_edges_[stop] = edge;
-		wait_edges_[edge_id] = WaitEdge{ stop->name, properties_.bus_wait_time * 1.0};
-	}
-	const auto buses = catalogue_.GetBuses();
-	for (const auto& bus : buses) {
-		AddBusToGraph(bus.stops.begin(), bus.stops.end(), bus.bus_num);
-		if (!bus.is_roundtrip) {
-			AddBusToGraph(bus.stops.rbegin(), bus.stops.rend(), bus.bus_num);
+	const CatalogueLayout& layout = catalogue_.GetLayout();
+	const size_t stop_count = layout.GetStopCount();
+	parallel::ThreadPool& pool = GetThreadPool();
+
+	// Число поездок маршрута зависит только от числа его остановок, поэтому номера поездок раздаются заранее,
+	// а маршруты заполняют свои отрезки параллельно
+	bus_first_rides_.assign(layout.GetBusCount() + 1, 0);
+	for (uint32_t bus_id = 0; bus_id < layout.GetBusCount(); ++bus_id) {
+		const size_t bus_stop_count = layout.GetBusStops(bus_id).size();
+		const size_t ride_count = bus_stop_count * (bus_stop_count - 1) / 2;
+		bus_first_rides_[bus_id + 1] = bus_first_rides_[bus_id] + static_cast<uint32_t>(layout.IsRoundtrip(bus_id) ? ride_count : 2 * ride_count);
+	}
+	const size_t ride_count = bus_first_rides_.back();
+	ride_distances_.resize(ride_count);
+	ride_span_counts_.resize(ride_count);
+	std::vector<uint32_t> ride_stops_from(ride_count);
+	std::vector<uint32_t> ride_stops_to(ride_count);
+	pool.ParallelFor(layout.GetBusCount(), [&](size_t bus_id) {
+		uint32_t ride = bus_first_rides_[bus_id];
+		ForEachBusRide(static_cast<uint32_t>(bus_id), [&](uint32_t from_id, uint32_t to_id, int span_count, int distance) {
+			ride_stops_from[ride] = from_id;
+			ride_stops_to[ride] = to_id;
+			ride_span_counts_[ride] = static_cast<uint32_t>(span_count);
+			ride_distances_[ride] = distance;
+			++ride;
+		});
+	});
+
+	stop_vertices_.resize(stop_count);
+	uint32_t vertex_pair = 0;
+	for (const Stop* stop : catalogue_.GetStopsPointers()) {
+		stop_vertices_[stop->id] = vertex_pair++;
+	}
+
+	std::vector<graph::Edge<double>> edges(stop_count);
+	edge_kinds_.assign(stop_count, EdgeKind::WAIT);
+	edge_owners_.resize(stop_count);
+	for (size_t i = 0; i < stop_count; ++i) {
+		const size_t vertex = 2 * stop_vertices_[i];
+		edges[i] = { vertex, vertex + 1, properties_.bus_wait_time * 1.0 };
+		edge_owners_[i] = static_cast<uint32_t>(i);
+	}
+	AddRideEdges(pool, ride_stops_from, ride_stops_to, edges);
+	graph_ = std::make_unique<graph::DirectedWeightedGraph<double>>(stop_count * 2, std::move(edges));
+}
+
+void TransportRouter::AddRideEdges(parallel::ThreadPool& pool, const std::vector<uint32_t>& ride_stops_from,
+	const std::vector<uint32_t>& ride_stops_to, std::vector<graph::Edge<double>>& edges) {
+	const size_t stop_count = catalogue_.GetLayout().GetStopCount();
+	const size_t ride_count = ride_distances_.size();
+
+	// Поездки группируются по остановке отправления подсчётом, внутри группы остаются по возрастанию номеров
+	std::vector<uint32_t> from_offsets(stop_count + 1, 0);
+	for (uint32_t from_id : ride_stops_from) {
+		++from_offsets[from_id + 1];
+	}
+	for (size_t i = 0; i < stop_count; ++i) {
+		from_offsets[i + 1] += from_offsets[i];
+	}
+	std::vector<uint32_t> rides_by_from(ride_count);
+	{
+		std::vector<uint32_t> positions(from_offsets.begin(), from_offsets.end() - 1);
+		for (uint32_t ride = 0; ride < ride_count; ++ride) {
+			rides_by_from[positions[ride_stops_from[ride]]++] = ride;
+		}
+	}
+
+	// Остановки отправления делятся на части, которые обрабатываются параллельно
+	const size_t part_count = std::min(stop_count, pool.GetThreadCount() * 4);
+	auto part_begin = [stop_count, part_count](size_t part) {
+		return static_cast<uint32_t>(part * stop_count / part_count);
+	};
+
+	// Первый проход считает рёбра каждой остановки. Рёбра нумеруются внутри остановки в порядке первых поездок,
+	// а выбранная поездка ребра хранится в representatives на месте поездок этой остановки.
+	std::vector<uint32_t> representatives(ride_count);
+	std::vector<uint32_t> from_edge_counts(stop_count, 0);
+	ride_edges_.resize(ride_count);
+	pool.ParallelFor(part_count, [&](size_t part) {
+		std::vector<uint32_t> last_from_by_stop_to(stop_count, std::numeric_limits<uint32_t>::max());
+		std::vector<uint32_t> local_edge_by_stop_to(stop_count);
+		for (uint32_t from_id = part_begin(part); from_id < part_begin(part + 1); ++from_id) {
+			uint32_t* from_representatives = representatives.data() + from_offsets[from_id];
+			uint32_t edge_count = 0;
+			for (uint32_t i = from_offsets[from_id]; i < from_offsets[from_id + 1]; ++i) {
+				const uint32_t ride = rides_by_from[i];
+				const uint32_t to_id = ride_stops_to[ride];
+				if (last_from_by_stop_to[to_id] != from_id) {
+					last_from_by_stop_to[to_id] = from_id;
+					local_edge_by_stop_to[to_id] = edge_count;
+					from_representatives[edge_count++] = ride;
+				}
+				else if (uint32_t& representative = from_representatives[local_edge_by_stop_to[to_id]];
+					ride_distances_[ride] < ride_distances_[representative]) {
+					representative = ride;
+				}
+				ride_edges_[ride] = local_edge_by_stop_to[to_id];
+			}
+			from_edge_counts[from_id] = edge_count;
+		}
+	});
+
+	// Рёбра остановок идут подряд после рёбер ожидания, второй проход заполняет их на заранее выделенных местах
+	std::vector<graph::EdgeId> from_first_edges(stop_count + 1, stop_count);
+	for (size_t i = 0; i < stop_count; ++i) {
+		from_first_edges[i + 1] = from_first_edges[i] + from_edge_counts[i];
+	}
+	const size_t edge_count = from_first_edges.back();
+	edges.resize(edge_count);
+	edge_kinds_.resize(edge_count, EdgeKind::BUS);
+	edge_owners_.resize(edge_count);
+	pool.ParallelFor(part_count, [&](size_t part) {
+		for (uint32_t from_id = part_begin(part); from_id < part_begin(part + 1); ++from_id) {
+			const uint32_t* from_representatives = representatives.data() + from_offsets[from_id];
+			for (uint32_t local_edge = 0; local_edge < from_edge_counts[from_id]; ++local_edge) {
+				const uint32_t ride = from_representatives[local_edge];
+				const graph::EdgeId edge_id = from_first_edges[from_id] + local_edge;
+				edges[edge_id] = { 2 * stop_vertices_[from_id] + 1, 2 * stop_vertices_[ride_stops_to[ride]], ComputeRideTime(ride_distances_[ride]) };
+				edge_owners_[edge_id] = ride;
+			}
+			for (uint32_t i = from_offsets[from_id]; i < from_offsets[from_id + 1]; ++i) {
+				ride_edges_[rides_by_from[i]] += from_first_edges[from_id];
+			}
 		}
+	});
+
+	edge_ride_offsets_.assign(edge_count + 1, 0);
+	for (graph::EdgeId edge_id : ride_edges_) {
+		++edge_ride_offsets_[edge_id + 1];
+	}
+	for (size_t i = 0; i < edge_count; ++i) {
+		edge_ride_offsets_[i + 1] += edge_ride_offsets_[i];
+	}
+	edge_rides_.resize(ride_count);
+	std::vector<uint32_t> positions(edge_ride_offsets_.begin(), edge_ride_offsets_.end() - 1);
+	for (uint32_t ride = 0; ride < ride_count; ++ride) {
+		edge_rides_[positions[ride_edges_[ride]]++] = ride;
 	}
+}
+
+void TransportRouter::UpdateBusEdges(uint32_t bus_id) {
+	uint32_t ride = bus_first_rides_.at(bus_id);
+	ForEachBusRide(bus_id, [this, &ride](uint32_t, uint32_t, int, int distance) {
+		ride_distances_[ride++] = distance;
+	});
+	for (ride = bus_first_rides_[bus_id]; ride < bus_first_rides_[bus_id + 1]; ++ride) {
+		UpdateRideEdge(ride_edges_[ride]);
+	}
+}
 
-	router_ = std::make_unique<graph::Router<double>>(*graph_);
+void TransportRouter::UpdateRideEdge(graph::EdgeId edge_id) {
+	uint32_t best_ride = edge_rides_[edge_ride_offsets_[edge_id]];
+	for (uint32_t i = edge_ride_offsets_[edge_id] + 1; i < edge_ride_offsets_[edge_id + 1]; ++i) {
+		if (ride_distances_[edge_rides_[i]] < ride_distances_[best_ride]) {
+			best_ride = edge_rides_[i];
+		}
+	}
+	edge_owners_[edge_id] = best_ride;
+	UpdateEdgeWeight(edge_id, ComputeRideTime(ride_distances_[best_ride]));
+}
+
+void TransportRouter::UpdateEdgeWeight(graph::EdgeId edge_id, double weight) {
+	const double old_weight = graph_->GetEdge(edge_id).weight;
+	if (old_weight == weight) {
+		return;
+	}
+	graph_->SetEdgeWeight(edge_id, weight);
+	if (router_) {
+		router_->UpdateEdgeWeight(edge_id, old_weight);
+	}
+}
+
+double TransportRouter::ComputeRideTime(int distance) const {
+	return ComputeRideTime(distance, properties_.bus_velocity);
+}
+
+double TransportRouter::ComputeRideTime(int distance, double bus_velocity) {
+	return (distance * 1.0) / (bus_velocity * KM_TO_M / H_TO_MIN);
+}
+
+size_t TransportRouter::GetRideCount() const {
+	return ride_distances_.size();
+}
+
+size_t TransportRouter::GetRideEdgeCount() const {
+	return graph_ ? graph_->GetEdgeCount() - catalogue_.GetLayout().GetStopCount() : 0;
 }
 
 std::optional<RouteAndEdgesInfo> TransportRouter::GetRoute(std::string_view from, std::string_view to) {
+	using namespace std::literals;
 	MakeGraph();
-	std::vector<std::variant<BusEdge, WaitEdge>> edges;
-	std::optional<graph::Router<double>::RouteInfo> route = router_->BuildRoute(stops_edges_.at(catalogue_.GetStop(from)).from, stops_edges_.at(catalogue_.GetStop(to)).from);
+	if (!router_) {
+		router_ = std::make_unique<graph::Router<double>>(*graph_, GetThreadPool());
+	}
+	const Stop* stop_from = catalogue_.GetStop(from);
+	const Stop* stop_to = catalogue_.GetStop(to);
+	if (!stop_from || !stop_to) {
+		throw std::out_of_range("Unknown stop"s);
+	}
+	std::optional<graph::Router<double>::RouteInfo> route = router_->BuildRoute(2 * stop_vertices_[stop_from->id], 2 * stop_vertices_[stop_to->id]);
 
 	if (!route) {
 		return std::nullopt;
 	}
 
+	std::vector<std::variant<BusEdge, WaitEdge>> edges;
+	edges.reserve(route.value().edges.size());
 	for (const auto& item : route.value().edges) {
-		const auto& item_info = GetEdgeInfo(item);
-		edges.push_back(item_info);
+		edges.push_back(GetEdgeInfo(item));
 	}
 
-	return RouteAndEdgesInfo{ route.value().weight, edges };
+	return RouteAndEdgesInfo{ route.value().weight, std::move(edges) };
 }
 
-std::variant<BusEdge, WaitEdge> TransportRouter::GetEdgeInfo(graph::EdgeId edge_id) {
-	if (wait_edges_.count(edge_id) != 0) {
-		return wait_edges_.at(edge_id);
+std::variant<BusEdge, WaitEdge> TransportRouter::GetEdgeInfo(graph::EdgeId edge_id) const {
+	const double time = graph_->GetEdge(edge_id).weight;
+	const CatalogueLayout& layout = catalogue_.GetLayout();
+	if (edge_kinds_[edge_id] == EdgeKind::WAIT) {
+		return WaitEdge{ layout.GetStopName(edge_owners_[edge_id]), time };
 	}
-	return bus_edges_.at(edge_id);
+	const uint32_t ride = edge_owners_[edge_id];
+	const auto bus_it = std::upper_bound(bus_first_rides_.begin(), bus_first_rides_.end(), ride) - 1;
+	return BusEdge{ layout.GetBusName(static_cast<uint32_t>(bus_it - bus_first_rides_.begin())), static_cast<int>(ride_span_counts_[ride]), time };
 }
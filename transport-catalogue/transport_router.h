@@ -3,7 +3,11 @@
 #include "graph.h"
 #include "request_handler.h"
 #include "router.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <iterator>
 #include <memory>
+#include <stdexcept>
 #include <variant>
 
 const int H_TO_MIN = 60;
@@ -14,13 +18,14 @@ struct RouterProps {
 	double bus_velocity = 1.0;
 };
 
+// Имена ссылаются на пул строк справочника
 struct WaitEdge {
-	std::string stop_name;
+	std::string_view stop_name;
 	double wait_time;
 };
 
 struct BusEdge {
-	std::string bus_name;
+	std::string_view bus_name;
 	int span_count;
 	double ride_time;
 };
@@ -35,40 +40,100 @@ public:
 	TransportRouter() = default;
 
 	TransportRouter(TransportCatalogue& catalogue)
-		: catalogue_(catalogue) {}
+		: catalogue_(catalogue)
+		, mutable_catalogue_(&catalogue) {}
+
+	// Граф строится по закреплённой версии справочника, изменение расстояний недоступно
+	explicit TransportRouter(VersionedCatalogue::Snapshot snapshot)
+		: snapshot_(std::move(snapshot))
+		, catalogue_(**snapshot_) {}
 
 	TransportRouter& SetBusWaitTime(int time);
 	TransportRouter& SetBusVelocity(double velocity);
+	// Меняет расстояние в справочнике, снова подготавливает его вызовом Finalize() и чинит граф на месте
+	TransportRouter& UpdateRoadDistance(std::string_view from, std::string_view to, int distance);
 
 	std::optional<RouteAndEdgesInfo> GetRoute(std::string_view from, std::string_view to);
+	// Время поездки в минутах на расстояние distance метров
+	double ComputeRideTime(int distance) const;
+	// То же для автобуса, едущего со скоростью bus_velocity км/ч
+	static double ComputeRideTime(int distance, double bus_velocity);
+	// Число поездок без пересадок и число рёбер поездок в построенном графе после слияния параллельных
+	size_t GetRideCount() const;
+	size_t GetRideEdgeCount() const;
 
 
 private:	
+	std::optional<VersionedCatalogue::Snapshot> snapshot_;
 	const TransportCatalogue& catalogue_;
+	TransportCatalogue* mutable_catalogue_ = nullptr;
 	RouterProps properties_;
 	std::unique_ptr<graph::DirectedWeightedGraph<double>> graph_;
 	std::unique_ptr<graph::Router<double>> router_;
-	std::unordered_map<const domain::Stop*, graph::Edge<double>> stops_edges_;
-	std::unordered_map<graph::EdgeId, WaitEdge> wait_edges_;
-	std::unordered_map<graph::EdgeId, BusEdge> bus_edges_;
+	// Один пул на маршрутизатор для построения графа и матрицы маршрутов, создаётся при первом построении
+	std::unique_ptr<parallel::ThreadPool> thread_pool_;
+	// Остановке с номером i соответствуют вершина прибытия 2 * stop_vertices_[i] и вершина отправления 2 * stop_vertices_[i] + 1.
+	// Пары вершин идут в порядке GetStopsPointers(): от порядка вершин зависит, какой из равных по времени
+	// маршрутов вернёт маршрутизатор.
+	std::vector<uint32_t> stop_vertices_;
+	// Поездки маршрута без пересадок пронумерованы подряд: маршрут i владеет отрезком [bus_first_rides_[i], bus_first_rides_[i + 1]).
+	// Из поездок между одной парой остановок в граф попадает одно ребро, а остальные ему проигрывают:
+	// у ребра та поездка, расстояние которой меньше, при равенстве — с меньшим номером.
+	std::vector<uint32_t> bus_first_rides_;
+	std::vector<int> ride_distances_;
+	std::vector<uint32_t> ride_span_counts_;
+	std::vector<graph::EdgeId> ride_edges_;
+	// Поездки ребра по возрастанию номеров: отрезок [edge_ride_offsets_[id], edge_ride_offsets_[id + 1]) массива edge_rides_
+	std::vector<uint32_t> edge_ride_offsets_;
+	std::vector<uint32_t> edge_rides_;
+
+	// Метаданные рёбер, индексированные по EdgeId. Для ребра ожидания владелец — индекс остановки,
+	// для ребра поездки — номер выбранной поездки. Время берётся из веса ребра в графе.
+	enum class EdgeKind : uint8_t {
+		WAIT,
+		BUS,
+	};
+	std::vector<EdgeKind> edge_kinds_;
+	std::vector<uint32_t> edge_owners_;
 	
+	parallel::ThreadPool& GetThreadPool();
 	void MakeGraph();
-	std::variant<BusEdge, WaitEdge> GetEdgeInfo(graph::EdgeId edge_id);
+	// Дописывает в edges рёбра поездок и заполняет их метаданные. Номера рёбер не зависят от числа потоков.
+	void AddRideEdges(parallel::ThreadPool& pool, const std::vector<uint32_t>& ride_stops_from,
+		const std::vector<uint32_t>& ride_stops_to, std::vector<graph::Edge<double>>& edges);
+	void UpdateBusEdges(uint32_t bus_id);
+	void UpdateRideEdge(graph::EdgeId edge_id);
+	void UpdateEdgeWeight(graph::EdgeId edge_id, double weight);
+	std::variant<BusEdge, WaitEdge> GetEdgeInfo(graph::EdgeId edge_id) const;
 
-	template <typename Iter>
-	void AddBusToGraph(Iter begin, Iter end, std::string bus_name) {
-		for (auto f_iter = begin; f_iter != end; ++f_iter) {
-			int distance = 0;
-			int span_count = 0;
+	// Перебирает все поездки автобуса без пересадок в порядке их номеров.
+	// Расстояние поездки — разность накопленных расстояний маршрута; для обратного прохода
+	// некольцевого маршрута накопленные расстояния считаются один раз на маршрут.
+	template <typename Callback>
+	void ForEachBusRide(uint32_t bus_id, Callback callback) const {
+		const CatalogueLayout& layout = catalogue_.GetLayout();
+		const CatalogueLayout::IdRange stops = layout.GetBusStops(bus_id);
+		if (stops.empty()) {
+			return;
+		}
+		const CatalogueLayout::DistanceRange prefix = layout.GetRoadDistancePrefix(bus_id);
+		ForEachBusRide(stops.begin(), stops.end(), prefix.begin(), callback);
+		if (!layout.IsRoundtrip(bus_id)) {
+			const auto reverse_stops = std::make_reverse_iterator(stops.end());
+			std::vector<int> reverse_prefix(stops.size(), 0);
+			for (size_t i = 1; i < stops.size(); ++i) {
+				reverse_prefix[i] = reverse_prefix[i - 1] + catalogue_.CountDistanceBetweenStops(reverse_stops[i - 1], reverse_stops[i]);
+			}
+			ForEachBusRide(reverse_stops, std::make_reverse_iterator(stops.begin()), reverse_prefix.begin(), callback);
+		}
+	}
 
-			for (auto s_iter = std::next(f_iter); s_iter != end; ++s_iter) {
-				span_count++;
-				distance += catalogue_.CountDistanceBetweenStops(*std::prev(s_iter), *s_iter);
-				graph::Edge<double> edge = { stops_edges_.at(*f_iter).to,
-												stops_edges_.at(*s_iter).from,
-												(distance * 1.0) / (properties_.bus_velocity * KM_TO_M / H_TO_MIN) };
-				graph::EdgeId edge_id = graph_->AddEdge(edge);
-				bus_edges_[edge_id] = BusEdge{ bus_name, span_count, graph_->GetEdge(edge_id).weight * 1.0 };
+	template <typename Iter, typename PrefixIter, typename Callback>
+	void ForEachBusRide(Iter begin, Iter end, PrefixIter distance_prefix, Callback& callback) const {
+		const size_t stop_count = static_cast<size_t>(std::distance(begin, end));
+		for (size_t from = 0; from < stop_count; ++from) {
+			for (size_t to = from + 1; to < stop_count; ++to) {
+				callback(begin[from], begin[to], static_cast<int>(to - from), distance_prefix[to] - distance_prefix[from]);
 			}
 		}
 	}
@@ -0,0 +1,81 @@
+#include "versioned_catalogue.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace transport_catalogue
+{
+	VersionedCatalogue::Snapshot::Snapshot(Snapshot&& other) noexcept
+		: slot_(other.slot_), catalogue_(other.catalogue_) {
+		other.slot_ = nullptr;
+		other.catalogue_ = nullptr;
+	}
+
+	VersionedCatalogue::Snapshot& VersionedCatalogue::Snapshot::operator=(Snapshot&& other) noexcept {
+		if (this != &other) {
+			Release();
+			slot_ = std::exchange(other.slot_, nullptr);
+			catalogue_ = std::exchange(other.catalogue_, nullptr);
+		}
+		return *this;
+	}
+
+	VersionedCatalogue::Snapshot::~Snapshot() {
+		Release();
+	}
+
+	void VersionedCatalogue::Snapshot::Release() {
+		if (slot_) {
+			slot_->epoch.store(FREE_SLOT, std::memory_order_release);
+			slot_ = nullptr;
+		}
+	}
+
+	VersionedCatalogue::VersionedCatalogue(TransportCatalogue catalogue) {
+		catalogue.Finalize();
+		current_ = new TransportCatalogue(std::move(catalogue));
+	}
+
+	VersionedCatalogue::~VersionedCatalogue() {
+		delete current_.load();
+	}
+
+	// Читатель сначала объявляет эпоху в свободном слоте и только потом читает указатель на версию.
+	// Писатель удаляет версию, только если все занятые слоты объявили эпоху не меньше эпохи её замены.
+	// Если все слоты заняты, ожидание свободного могло бы не закончиться никогда: например, когда снимки
+	// держит сам вызывающий поток. Поэтому нехватка слотов — ошибка, а не повод ждать.
+	VersionedCatalogue::Snapshot VersionedCatalogue::GetSnapshot() {
+		using namespace std::literals;
+		for (auto& slot : reader_slots_) {
+			uint64_t expected = FREE_SLOT;
+			if (slot.epoch.compare_exchange_strong(expected, epoch_.load())) {
+				return Snapshot(&slot, current_.load());
+			}
+		}
+		throw std::runtime_error("Too many catalogue snapshots"s);
+	}
+
+	void VersionedCatalogue::Publish(TransportCatalogue catalogue) {
+		std::lock_guard lock(writer_mutex_);
+		catalogue.Finalize();
+		PublishLocked(std::make_unique<TransportCatalogue>(std::move(catalogue)));
+	}
+
+	void VersionedCatalogue::PublishLocked(std::unique_ptr<const TransportCatalogue> catalogue) {
+		const TransportCatalogue* previous = current_.exchange(catalogue.release());
+		const uint64_t retire_epoch = epoch_.fetch_add(1) + 1;
+		retired_.push_back({ std::unique_ptr<const TransportCatalogue>(previous), retire_epoch });
+		ReclaimRetired();
+	}
+
+	void VersionedCatalogue::ReclaimRetired() {
+		uint64_t min_active_epoch = FREE_SLOT;
+		for (const auto& slot : reader_slots_) {
+			min_active_epoch = std::min(min_active_epoch, slot.epoch.load());
+		}
+		retired_.erase(std::remove_if(retired_.begin(), retired_.end(),
+			[min_active_epoch](const RetiredVersion& version) {
+				return version.retire_epoch <= min_active_epoch;
+			}), retired_.end());
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "transport_catalogue.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace transport_catalogue
+{
+    // Версионированный справочник в стиле RCU: писатели собирают новую неизменяемую версию
+    // и атомарно публикуют её, читатели закрепляют текущую версию без блокировок.
+    // Старая версия удаляется, когда не остаётся читателей, закрепивших её раньше публикации.
+    class VersionedCatalogue {
+    public:
+        // Наибольшее число одновременно существующих снимков
+        static constexpr size_t MAX_READERS = 64;
+
+    private:
+        static constexpr uint64_t FREE_SLOT = std::numeric_limits<uint64_t>::max();
+
+        struct alignas(64) ReaderSlot {
+            std::atomic<uint64_t> epoch = FREE_SLOT;
+        };
+
+    public:
+        class Snapshot {
+        public:
+            Snapshot(Snapshot&& other) noexcept;
+            Snapshot& operator=(Snapshot&& other) noexcept;
+            Snapshot(const Snapshot&) = delete;
+            Snapshot& operator=(const Snapshot&) = delete;
+            ~Snapshot();
+
+            const TransportCatalogue& operator*() const {
+                return *catalogue_;
+            }
+            const TransportCatalogue* operator->() const {
+                return catalogue_;
+            }
+
+        private:
+            friend class VersionedCatalogue;
+            Snapshot(ReaderSlot* slot, const TransportCatalogue* catalogue)
+                : slot_(slot), catalogue_(catalogue) {}
+            void Release();
+
+            ReaderSlot* slot_;
+            const TransportCatalogue* catalogue_;
+        };
+
+        explicit VersionedCatalogue(TransportCatalogue catalogue = {});
+        ~VersionedCatalogue();
+
+        VersionedCatalogue(const VersionedCatalogue&) = delete;
+        VersionedCatalogue& operator=(const VersionedCatalogue&) = delete;
+
+        // Бросает std::runtime_error, если уже существует MAX_READERS снимков
+        Snapshot GetSnapshot();
+        void Publish(TransportCatalogue catalogue);
+
+        // Копирует текущую версию, применяет к копии edit(TransportCatalogue&) и публикует результат.
+        // Опубликованные версии всегда подготовлены для запросов вызовом Finalize()
+        template <typename Func>
+        void Update(Func edit) {
+            std::lock_guard lock(writer_mutex_);
+            auto draft = std::make_unique<TransportCatalogue>(*current_.load());
+            edit(*draft);
+            draft->Finalize();
+            PublishLocked(std::move(draft));
+        }
+
+    private:
+        struct RetiredVersion {
+            std::unique_ptr<const TransportCatalogue> catalogue;
+            uint64_t retire_epoch;
+        };
+
+        void PublishLocked(std::unique_ptr<const TransportCatalogue> catalogue);
+        void ReclaimRetired();
+
+        std::atomic<const TransportCatalogue*> current_;
+        std::atomic<uint64_t> epoch_ = 0;
+        std::array<ReaderSlot, MAX_READERS> reader_slots_;
+        std::mutex writer_mutex_;
+        std::vector<RetiredVersion> retired_;
+    };
+}